@@ -11,7 +11,9 @@
 #include "BattleAI.h"
 #include "StackWithBonuses.h"
 #include "EnemyInfo.h"
+#include "../../lib/battle/BattleStateSnapshot.h"
 #include "../../lib/spells/CSpellHandler.h"
+#include "../../lib/CThreadHelper.h"
 
 #define LOGL(text) print(text)
 #define LOGFL(text, formattingEl) print(boost::str(boost::format(text) % formattingEl))
@@ -79,7 +81,7 @@ BattleAction CBattleAI::activeStack( const CStack * stack )
 		PotentialTargets targets(stack);
 		if(targets.possibleAttacks.size())
 		{
-			auto hlp = targets.bestAction();
+			auto hlp = chooseAttack(stack, targets);
 			if(hlp.attack.shooting)
 				return BattleAction::makeShotAttack(stack, hlp.enemy);
 			else
@@ -110,6 +112,38 @@ BattleAction CBattleAI::activeStack( const CStack * stack )
 	return BattleAction::makeDefend(stack);
 }
 
+AttackPossibility CBattleAI::chooseAttack(const CStack * stack, const PotentialTargets & targets) const
+{
+	//each attack is played on a copy of battle followed by enemy's reply, the one leaving us in best position wins
+	const BattleStateSnapshot snapshot(cb.get());
+	const ui8 enemySide = 1 - stack->side;
+
+	const AttackPossibility * best = nullptr;
+	si64 bestValue = 0;
+	for(auto & ap : targets.possibleAttacks)
+	{
+		BattleStateSnapshot state = snapshot;
+		auto attacker = state.find(stack);
+		auto defender = state.find(ap.enemy);
+		if(!attacker || !defender)
+			continue;
+
+		if(!ap.attack.shooting)
+			state.move(*attacker, ap.tile);
+		state.attack(*attacker, *defender, ap.attack.shooting);
+		state.playGreedyTurn(enemySide);
+
+		//attack value of PotentialTargets decides between equal outcomes
+		const si64 value = state.value(stack->side);
+		if(!best || value > bestValue || (value == bestValue && ap.attackValue() > best->attackValue()))
+		{
+			best = &ap;
+			bestValue = value;
+		}
+	}
+	return best ? *best : targets.bestAction();
+}
+
 BattleAction CBattleAI::goTowards(const CStack * stack, BattleHex destination)
 {
 	assert(destination.isValid());
@@ -117,14 +151,18 @@ BattleAction CBattleAI::goTowards(const CStack * stack, BattleHex destination)
 	auto reachability = cb->getReachability(stack);
 	if(vstd::contains(avHexes, destination))
 		return BattleAction::makeMove(stack, destination);
-	auto destNeighbours = destination.neighbouringTiles();
-	if(vstd::contains_if(destNeighbours, [&](BattleHex n) { return stack->coversPos(destination); }))
+	if(vstd::contains_if(destination.neighbours(), [&](BattleHex n) { return stack->coversPos(destination); }))
 	{
 		logAi->warn("Warning: already standing on neighbouring tile!");
 		//We shouldn't even be here...
 		return BattleAction::makeDefend(stack);
 	}
-	vstd::erase_if(destNeighbours, [&](BattleHex hex){ return !reachability.accessibility.accessible(hex, stack); });
+	std::vector<BattleHex> destNeighbours;
+	for(BattleHex hex : destination.neighbours())
+	{
+		if(reachability.accessibility.accessible(hex, stack))
+			destNeighbours.push_back(hex);
+	}
 	if(!avHexes.size() || !destNeighbours.size()) //we are blocked or dest is blocked
 	{
 		return BattleAction::makeDefend(stack);
@@ -266,7 +304,7 @@ void CBattleAI::attemptCastingSpell()
 				state.bonusesOfStacks[swb.stack] = &swb;
 				PotentialTargets pt(swb.stack, state);
 				auto newValue = pt.bestActionValue();
-				auto oldValue = valueOfStack[swb.stack];
+				auto oldValue = valueOfStack.at(swb.stack);
 				auto gain = newValue - oldValue;
 				if(swb.stack->owner != playerID) //enemy
 					gain = -gain;
@@ -284,8 +322,13 @@ void CBattleAI::attemptCastingSpell()
 		}
 	};
 
-	for(PossibleSpellcast & psc : possibleCasts)
+	//evaluations only read battle state, so they are spread over all cores
+	parallelForEach(possibleCasts, [&](PossibleSpellcast & psc)
+	{
 		psc.value = evaluateSpellcast(psc);
+	}, boost::thread::hardware_concurrency());
+
+	//first of equally good casts is chosen, so result doesn't depend on order in which evaluations finished
 	auto pscValue = [] (const PossibleSpellcast &ps) -> int
 	{
 		return ps.value;
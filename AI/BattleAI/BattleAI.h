@@ -68,6 +68,7 @@ public:
 	void attemptCastingSpell();
 
 	BattleAction activeStack(const CStack * stack) override; //called when it's turn of that stack
+	AttackPossibility chooseAttack(const CStack * stack, const PotentialTargets & targets) const; //looks one enemy turn ahead
 	BattleAction goTowards(const CStack * stack, BattleHex hex );
 
 	boost::optional<BattleAction> considerFleeingOrSurrendering();
@@ -19,5 +19,7 @@ public:
 	mutable std::vector<Bonus> bonusesToAdd;
 
 	virtual const TBonusListPtr getAllBonuses(const CSelector &selector, const CSelector &limit,
-						  const CBonusSystemNode *root = nullptr, const std::string &cachingStr = "") const override;
+						  const CBonusSystemNode *root = nullptr, TBonusCacheKey cachingKey = 0) const override;
+
+	si64 getTreeVersion() const override;
 };
@@ -173,13 +173,13 @@ void foreach_neighbour(CCallback * cbp, const int3 &pos, std::function<void(CCal
 
 bool CDistanceSorter::operator ()(const CGObjectInstance *lhs, const CGObjectInstance *rhs)
 {
-	const CGPathNode *ln = ai->myCb->getPathsInfo(hero)->getPathInfo(lhs->visitablePos()),
-	                 *rn = ai->myCb->getPathsInfo(hero)->getPathInfo(rhs->visitablePos());
+	const CGPathNode ln = ai->myCb->getPathsInfo(hero)->getPathInfo(lhs->visitablePos()),
+	                 rn = ai->myCb->getPathsInfo(hero)->getPathInfo(rhs->visitablePos());
 
-	if(ln->turns != rn->turns)
-		return ln->turns < rn->turns;
+	if(ln.turns != rn.turns)
+		return ln.turns < rn.turns;
 
-	return (ln->moveRemains > rn->moveRemains);
+	return (ln.moveRemains > rn.moveRemains);
 }
 
 bool compareMovement(HeroPtr lhs, HeroPtr rhs)
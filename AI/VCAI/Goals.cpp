@@ -918,13 +918,13 @@ TSubgoal GatherTroops::whatToDoToAchieve()
 		// sorted helper
 		auto comparator = [](const TDwellMap::value_type & a, const TDwellMap::value_type & b) -> bool
 		{
-			const CGPathNode *ln = ai->myCb->getPathsInfo(a.first)->getPathInfo(a.second->visitablePos()),
-			                 *rn = ai->myCb->getPathsInfo(b.first)->getPathInfo(b.second->visitablePos());
+			const CGPathNode ln = ai->myCb->getPathsInfo(a.first)->getPathInfo(a.second->visitablePos()),
+			                 rn = ai->myCb->getPathsInfo(b.first)->getPathInfo(b.second->visitablePos());
 
-			if(ln->turns != rn->turns)
-				return ln->turns < rn->turns;
+			if(ln.turns != rn.turns)
+				return ln.turns < rn.turns;
 
-			return (ln->moveRemains > rn->moveRemains);
+			return (ln.moveRemains > rn.moveRemains);
 		};
 
 		// for all owned heroes generate map <hero -> nearest dwelling>
@@ -789,6 +789,9 @@ void VCAI::makeTurnInternal()
 	for(const CGTownInstance *t : cb->getTownsInfo())
 		moveCreaturesToHero(t);
 
+	//paths of all our heroes are needed for decisions below, calculate them together
+	cb->preparePaths(cb->getHeroesInfo());
+
 	try
 	{
 		//Pick objects reserved in previous turn - we expect only nerby objects there
@@ -1887,7 +1890,7 @@ bool VCAI::isAccessibleForHero(const int3 & pos, HeroPtr h, bool includeAllies)
 				return false;
 		}
 	}
-	return cb->getPathsInfo(h.get())->getPathInfo(pos)->reachable();
+	return cb->getPathsInfo(h.get())->getPathInfo(pos).reachable();
 }
 
 bool VCAI::moveHeroToTile(int3 dst, HeroPtr h)
@@ -2600,9 +2603,9 @@ int3 VCAI::explorationBestNeighbour(int3 hpos, int radius, HeroPtr h)
 	auto best = dstToRevealedTiles.begin();
 	for (auto i = dstToRevealedTiles.begin(); i != dstToRevealedTiles.end(); i++)
 	{
-		const CGPathNode *pn = cb->getPathsInfo(h.get())->getPathInfo(i->first);
+		const CGPathNode pn = cb->getPathsInfo(h.get())->getPathInfo(i->first);
 		//const TerrainTile *t = cb->getTile(i->first);
-		if(best->second < i->second && pn->reachable() && pn->accessible == CGPathNode::ACCESSIBLE)
+		if(best->second < i->second && pn.reachable() && pn.accessible == CGPathNode::ACCESSIBLE)
 			best = i;
 	}
 
@@ -2640,7 +2643,7 @@ int3 VCAI::explorationNewPoint(HeroPtr h)
 		{
 			if (tile == ourPos) //shouldn't happen, but it does
 				continue;
-			if (!cb->getPathsInfo(hero)->getPathInfo(tile)->reachable()) //this will remove tiles that are guarded by monsters (or removable objects)
+			if (!cb->getPathsInfo(hero)->getPathInfo(tile).reachable()) //this will remove tiles that are guarded by monsters (or removable objects)
 				continue;
 
 			CGPath path;
@@ -3493,7 +3496,7 @@ int3 SectorMap::findFirstVisitableTile (HeroPtr h, crint3 dst)
 			logAi->warn("Another allied hero stands in our way");
 			return ret;
 		}
-		if(ai->myCb->getPathsInfo(h.get())->getPathInfo(curtile)->reachable())
+		if(ai->myCb->getPathsInfo(h.get())->getPathInfo(curtile).reachable())
 		{
 			return curtile;
 		}
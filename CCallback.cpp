@@ -302,6 +302,11 @@ const CPathsInfo * CCallback::getPathsInfo(const CGHeroInstance *h)
 	return cl->getPathsInfo(h);
 }
 
+void CCallback::preparePaths(const std::vector<const CGHeroInstance *> & heroes)
+{
+	cl->preparePaths(heroes);
+}
+
 int3 CCallback::getGuardingCreaturePosition(int3 tile)
 {
 	if (!gs->map->isInTheMap(tile))
@@ -106,6 +106,7 @@ public:
 	virtual bool canMoveBetween(const int3 &a, const int3 &b);
 	virtual int3 getGuardingCreaturePosition(int3 tile);
 	virtual const CPathsInfo * getPathsInfo(const CGHeroInstance *h);
+	virtual void preparePaths(const std::vector<const CGHeroInstance *> & heroes); //calculates paths of heroes in parallel, results are returned by getPathsInfo
 
 	virtual void calculatePaths(const CGHeroInstance *hero, CPathsInfo &out);
 
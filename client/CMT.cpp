@@ -53,6 +53,7 @@
 #include "../lib/logging/CBasicLogConfigurator.h"
 #include "../lib/StringConstants.h"
 #include "../lib/CPlayerState.h"
+#include "../lib/serializer/CPackStatistics.h"
 #include "gui/CAnimation.h"
 
 #ifdef VCMI_WINDOWS
@@ -310,6 +311,7 @@ int main(int argc, char * argv[])
 	// Init filesystem and settings
 	preinitDLL(::console);
 	settings.init();
+	CPackStatistics::get().setEnabled(settings["general"]["packStatistics"].Bool());
 	Settings session = settings.write["session"];
 	session["onlyai"].Bool() = vm.count("onlyAI");
 	if(vm.count("headless"))
@@ -732,6 +734,17 @@ void processCommand(const std::string &message)
 			std::cout << "\nBonuses from " << typeid(*parent).name() << std::endl << parent->getBonusList() << std::endl;
 		}
 	}
+	else if(cn == "packs")
+	{
+		std::string what;
+		readed >> what;
+		if(what == "clear")
+			CPackStatistics::get().clear();
+		else if(what == "on" || what == "off")
+			CPackStatistics::get().setEnabled(what == "on");
+		else
+			std::cout << CPackStatistics::get().toString();
+	}
 	else if(cn == "not dialog")
 	{
 		LOCPLINT->showingDialog->setn(false);
@@ -34,6 +34,7 @@
 #include "../lib/serializer/CTypeList.h"
 #include "../lib/serializer/Connection.h"
 #include "../lib/serializer/CLoadIntegrityValidator.h"
+#include "../lib/serializer/CPackStatistics.h"
 #ifndef VCMI_ANDROID
 #include "../lib/Interprocess.h"
 #endif
@@ -47,6 +48,7 @@
 #include "CPreGame.h"
 #include "battle/CBattleInterface.h"
 #include "../lib/CThreadHelper.h"
+#include "../lib/ScopeGuard.h"
 #include "../lib/CScriptingModule.h"
 #include "../lib/registerTypes/RegisterTypes.h"
 #include "gui/CGuiHandler.h"
@@ -119,7 +121,7 @@ void CClient::init()
 		TLockGuard _(connectionHandlerMutex);
 		connectionHandler.reset();
 	}
-	pathInfo = nullptr;
+	pathCache.reset();
 	applier = new CApplier<CBaseForCLApply>();
 	registerTypesClientPacks1(*applier);
 	registerTypesClientPacks2(*applier);
@@ -185,7 +187,16 @@ void CClient::run()
 				break;
 			}
 
+			//rest of frame holds packs server sent as batch, they are applied together and paths are invalidated once
+			pathCache->beginInvalidationBatch();
+			auto batchGuard = vstd::makeScopeGuard([&]()
+			{
+				pathCache->endInvalidationBatch();
+			});
+
 			handlePack(pack);
+			while(!terminate && serv->hasBufferedInput())
+				handlePack(serv->retreivePack());
 		}
 	}
 	//catch only asio exceptions
@@ -253,6 +264,16 @@ void CClient::endGame(bool closeConnection)
 	CGMagi::reset();
 	CGObelisk::reset();
 	logNetwork->info("Deleted playerInts.");
+
+	try
+	{
+		if(CPackStatistics::get().isEnabled())
+			CPackStatistics::get().writeCsv(VCMIDirs::get().userCachePath() / "VCMI_Client_packs.csv");
+	}
+	catch(std::exception & e)
+	{
+		logNetwork->error("Failed to write pack statistics: %s", e.what());
+	}
 	logNetwork->info("Client stopped.");
 }
 
@@ -298,7 +319,7 @@ void CClient::loadGame(const std::string & fname, const bool server, const std::
 		logNetwork->info("Loaded common part of save %d ms", tmh.getDiff());
 		const_cast<CGameInfo*>(CGI)->mh = new CMapHandler();
 		const_cast<CGameInfo*>(CGI)->mh->map = gs->map;
-		pathInfo = make_unique<CPathsInfo>(getMapSize());
+		pathCache = make_unique<CPathsCache>(gs, getMapSize());
 		CGI->mh->init();
 		logNetwork->info("Initing maphandler: %d ms", tmh.getDiff());
 	}
@@ -445,7 +466,7 @@ void CClient::newGame( CConnection *con, StartInfo *si )
 			logNetwork->info("Creating mapHandler: %d ms", tmh.getDiff());
 			CGI->mh->init();
 		}
-		pathInfo = make_unique<CPathsInfo>(getMapSize());
+		pathCache = make_unique<CPathsCache>(gs, getMapSize());
 		logNetwork->info("Initializing mapHandler (together): %d ms", tmh.getDiff());
 	}
 
@@ -678,11 +699,16 @@ void CClient::handlePack( CPack * pack )
 	if(apply)
 	{
 		boost::unique_lock<boost::recursive_mutex> guiLock(*CPlayerInterface::pim);
+		CPackStatistics::Timer timerBefore;
 		apply->applyOnClBefore(this, pack);
+		double clientTime = timerBefore.elapsed();
 		logNetwork->trace("\tMade first apply on cl");
 		gs->apply(pack);
 		logNetwork->trace("\tApplied on gs");
+		CPackStatistics::Timer timerAfter;
 		apply->applyOnClAfter(this, pack);
+		clientTime += timerAfter.elapsed();
+		CPackStatistics::get().addAppliedCl(pack, clientTime);
 		logNetwork->trace("\tMade second apply on cl");
 	}
 	else
@@ -864,20 +890,27 @@ void CClient::commenceTacticPhaseForInt(std::shared_ptr<CBattleGameInterface> ba
 
 void CClient::invalidatePaths()
 {
-	// turn pathfinding info into invalid. It will be regenerated later
-	boost::unique_lock<boost::mutex> pathLock(pathInfo->pathMx);
-	pathInfo->hero = nullptr;
+	pathCache->invalidate();
+}
+
+void CClient::invalidatePaths(const CGObjectInstance * obj)
+{
+	pathCache->invalidate(obj);
+}
+
+void CClient::invalidatePaths(const std::unordered_set<int3, ShashInt3> & tiles)
+{
+	pathCache->invalidate(tiles);
 }
 
 const CPathsInfo * CClient::getPathsInfo(const CGHeroInstance *h)
 {
-	assert(h);
-	boost::unique_lock<boost::mutex> pathLock(pathInfo->pathMx);
-	if (pathInfo->hero != h)
-	{
-		gs->calculatePaths(h, *pathInfo.get());
-	}
-	return pathInfo.get();
+	return pathCache->get(h);
+}
+
+void CClient::preparePaths(const std::vector<const CGHeroInstance *> & heroes)
+{
+	pathCache->prepare(heroes);
 }
 
 int CClient::sendRequest(const CPack *request, PlayerColor player)
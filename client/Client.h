@@ -31,6 +31,7 @@ struct SharedMemory;
 class CClient;
 class CScriptingModule;
 struct CPathsInfo;
+class CPathsCache;
 class BinaryDeserializer;
 class BinarySerializer;
 namespace boost { class thread; }
@@ -122,7 +123,7 @@ public:
 /// Class which handles client - server logic
 class CClient : public IGameCallback
 {
-	std::unique_ptr<CPathsInfo> pathInfo;
+	std::unique_ptr<CPathsCache> pathCache;
 public:
 	std::map<PlayerColor,std::shared_ptr<CCallback> > callbacks; //callbacks given to player interfaces
 	std::map<PlayerColor,std::shared_ptr<CBattleCallback> > battleCallbacks; //callbacks given to player interfaces
@@ -168,7 +169,10 @@ public:
 	void proposeNextMission(std::shared_ptr<CCampaignState> camp);
 
 	void invalidatePaths();
+	void invalidatePaths(const CGObjectInstance * obj); //paths are only repaired around tiles occupied by object
+	void invalidatePaths(const std::unordered_set<int3, ShashInt3> & tiles);
 	const CPathsInfo * getPathsInfo(const CGHeroInstance *h);
+	void preparePaths(const std::vector<const CGHeroInstance *> & heroes); //calculates paths of several heroes at once so getPathsInfo can return them immediately
 
 	bool terminate;	// tell to terminate
 	std::unique_ptr<boost::thread> connectionHandler; //thread running run() method
@@ -163,7 +163,7 @@ void SetMana::applyCl(CClient *cl)
 void SetMovePoints::applyCl(CClient *cl)
 {
 	const CGHeroInstance *h = cl->getHero(hid);
-	cl->invalidatePaths();
+	cl->invalidatePaths(h);
 	INTERFACE_CALL_IF_PRESENT(h->tempOwner, heroMovePointsChanged, h);
 }
 
@@ -183,7 +183,7 @@ void FoWChange::applyCl(CClient *cl)
 				i.second->tileHidden(tiles);
 		}
 	}
-	cl->invalidatePaths();
+	cl->invalidatePaths(tiles);
 }
 
 void SetAvailableHeroes::applyCl(CClient *cl)
@@ -266,21 +266,25 @@ void NewTurn::applyCl(CClient *cl)
 
 void GiveBonus::applyCl(CClient *cl)
 {
-	cl->invalidatePaths();
 	switch(who)
 	{
 	case HERO:
 		{
 			const CGHeroInstance *h = GS(cl)->getHero(ObjectInstanceID(id));
+			cl->invalidatePaths(h);
 			INTERFACE_CALL_IF_PRESENT(h->tempOwner, heroBonusChanged, h, *h->getBonusList().back(),true);
 		}
 		break;
 	case PLAYER:
 		{
+			cl->invalidatePaths();
 			const PlayerState *p = GS(cl)->getPlayer(PlayerColor(id));
 			INTERFACE_CALL_IF_PRESENT(PlayerColor(id), playerBonusChanged, *p->getBonusList().back(), true);
 		}
 		break;
+	default:
+		cl->invalidatePaths();
+		break;
 	}
 }
 
@@ -289,6 +293,8 @@ void ChangeObjPos::applyFirstCl(CClient *cl)
 	CGObjectInstance *obj = GS(cl)->getObjInstance(objid);
 	if(flags & 1 && CGI->mh)
 		CGI->mh->hideObject(obj);
+
+	cl->invalidatePaths(obj);
 }
 void ChangeObjPos::applyCl(CClient *cl)
 {
@@ -296,7 +302,7 @@ void ChangeObjPos::applyCl(CClient *cl)
 	if(flags & 1 && CGI->mh)
 		CGI->mh->printObject(obj);
 
-	cl->invalidatePaths();
+	cl->invalidatePaths(obj);
 }
 
 void PlayerEndsGame::applyCl(CClient *cl)
@@ -310,21 +316,25 @@ void PlayerEndsGame::applyCl(CClient *cl)
 
 void RemoveBonus::applyCl(CClient *cl)
 {
-	cl->invalidatePaths();
 	switch(who)
 	{
 	case HERO:
 		{
 			const CGHeroInstance *h = GS(cl)->getHero(ObjectInstanceID(id));
+			cl->invalidatePaths(h);
 			INTERFACE_CALL_IF_PRESENT(h->tempOwner, heroBonusChanged, h, bonus,false);
 		}
 		break;
 	case PLAYER:
 		{
+			cl->invalidatePaths();
 			//const PlayerState *p = GS(cl)->getPlayer(id);
 			INTERFACE_CALL_IF_PRESENT(PlayerColor(id), playerBonusChanged, bonus, false);
 		}
 		break;
+	default:
+		cl->invalidatePaths();
+		break;
 	}
 }
 
@@ -346,6 +356,8 @@ void RemoveObject::applyFirstCl(CClient *cl)
 	if(CGI->mh)
 		CGI->mh->hideObject(o, true);
 
+	cl->invalidatePaths(o);
+
 	//notify interfaces about removal
 	for(auto i=cl->playerint.begin(); i!=cl->playerint.end(); i++)
 	{
@@ -354,14 +366,10 @@ void RemoveObject::applyFirstCl(CClient *cl)
 	}
 }
 
-void RemoveObject::applyCl(CClient *cl)
-{
-	cl->invalidatePaths();
-}
-
 void TryMoveHero::applyFirstCl(CClient *cl)
 {
 	CGHeroInstance *h = GS(cl)->getHero(id);
+	cl->invalidatePaths(h);
 
 	//check if playerint will have the knowledge about movement - if not, directly update maphandler
 	for(auto i=cl->playerint.begin(); i!=cl->playerint.end(); i++)
@@ -387,7 +395,8 @@ void TryMoveHero::applyFirstCl(CClient *cl)
 void TryMoveHero::applyCl(CClient *cl)
 {
 	const CGHeroInstance *h = cl->getHero(id);
-	cl->invalidatePaths();
+	cl->invalidatePaths(h);
+	cl->invalidatePaths(fowRevealed);
 
 	if(CGI->mh)
 	{
@@ -812,7 +821,7 @@ void SaveGame::applyCl(CClient *cl)
 
 	try
 	{
-		CSaveFile save(*CResourceHandler::get()->getResourceName(ResourceID(stem.to_string(), EResType::CLIENT_SAVEGAME)));
+		CSaveFile save(*CResourceHandler::get()->getResourceName(ResourceID(stem.to_string(), EResType::CLIENT_SAVEGAME)), settings["general"]["compressSaves"].Bool());
 		cl->saveCommonState(save);
 		save << *cl;
 	}
@@ -923,9 +932,8 @@ void CenterView::applyCl(CClient *cl)
 
 void NewObject::applyCl(CClient *cl)
 {
-	cl->invalidatePaths();
-
 	const CGObjectInstance *obj = cl->getObj(id);
+	cl->invalidatePaths(obj);
 	if(CGI->mh)
 		CGI->mh->printObject(obj, true);
 
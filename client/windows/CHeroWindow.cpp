@@ -40,7 +40,7 @@
 #include "../mapHandler.h"
 
 
-const TBonusListPtr CHeroWithMaybePickedArtifact::getAllBonuses(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root, const std::string & cachingStr) const
+const TBonusListPtr CHeroWithMaybePickedArtifact::getAllBonuses(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root, TBonusCacheKey cachingKey) const
 {
 	TBonusListPtr out(new BonusList());
 	TBonusListPtr heroBonuses = hero->getAllBonuses(selector, limit, hero);
@@ -66,6 +66,11 @@ CHeroWithMaybePickedArtifact::CHeroWithMaybePickedArtifact(CWindowWithArtifacts
 {
 }
 
+si64 CHeroWithMaybePickedArtifact::getTreeVersion() const
+{
+	return hero->getTreeVersion();  //this assumes that bonuses from picked up artifact won't change
+}
+
 void CHeroSwitcher::clickLeft(tribool down, bool previousState)
 {
 	if(!down)
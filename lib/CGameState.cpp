@@ -36,7 +36,9 @@
 #include "mapping/CMapService.h"
 #include "serializer/CTypeList.h"
 #include "serializer/CMemorySerializer.h"
+#include "serializer/CPackStatistics.h"
 #include "VCMIDirs.h"
+#include "CThreadHelper.h"
 
 #ifdef min
 #undef min
@@ -1962,8 +1964,10 @@ PlayerRelations::PlayerRelations CGameState::getPlayerRelations( PlayerColor col
 
 void CGameState::apply(CPack *pack)
 {
+	CPackStatistics::Timer timer;
 	ui16 typ = typeList.getTypeID(pack);
 	applierGs->getApplier(typ)->applyOnGS(this,pack);
+	CPackStatistics::get().addAppliedGs(pack, timer.elapsed());
 }
 
 void CGameState::calculatePaths(const CGHeroInstance *hero, CPathsInfo &out)
@@ -1972,6 +1976,20 @@ void CGameState::calculatePaths(const CGHeroInstance *hero, CPathsInfo &out)
 	pathfinder.calculatePaths();
 }
 
+void CGameState::updatePaths(const CGHeroInstance *hero, CPathsInfo &out)
+{
+	CPathfinder pathfinder(out, this, hero);
+	pathfinder.updatePaths();
+}
+
+void CGameState::calculatePaths(const std::map<const CGHeroInstance *, CPathsInfo *> & paths)
+{
+	parallelForEach(paths, [this](const std::pair<const CGHeroInstance * const, CPathsInfo *> & path)
+	{
+		calculatePaths(path.first, *path.second);
+	}, boost::thread::hardware_concurrency());
+}
+
 /**
  * Tells if the tile is guarded by a monster as well as the position
  * of the monster that will attack on it.
@@ -37,12 +37,12 @@ CPathfinder::PathfinderOptions::PathfinderOptions()
 }
 
 CPathfinder::CPathfinder(CPathsInfo & _out, CGameState * _gs, const CGHeroInstance * _hero)
-	: CGameInfoCallback(_gs, boost::optional<PlayerColor>()), out(_out), hero(_hero), FoW(getPlayerTeam(hero->tempOwner)->fogOfWarMap), patrolTiles({})
+	: CGameInfoCallback(_gs, boost::optional<PlayerColor>()), out(_out), hero(_hero), FoW(getPlayerTeam(hero->tempOwner)->fogOfWarMap), patrolTiles({}), pq(_out)
 {
 	assert(hero);
 	assert(hero == getHero(hero->id));
 
-    cp = dp = nullptr;
+    cpIndex = dpIndex = CPathsInfo::NO_NODE;
     ct = dt = nullptr;
     ctObj = dtObj = nullptr;
     destAction = CGPathNode::UNKNOWN;
@@ -58,23 +58,197 @@ CPathfinder::CPathfinder(CPathsInfo & _out, CGameState * _gs, const CGHeroInstan
 	hlp = make_unique<CPathfinderHelper>(hero, options);
 
 	initializePatrol();
-	initializeGraph();
 	neighbourTiles.reserve(8);
 	neighbours.reserve(16);
 }
 
 void CPathfinder::calculatePaths()
+{
+	//logGlobal->info("Calculating paths for hero %s (adress  %d) of player %d", hero->name, hero , hero->tempOwner);
+
+	out.changedTiles.clear();
+	initializeGraph();
+
+	//initial tile - set cost on 0 and add to the queue
+	const ui32 initialNode = out.getNodeIndex(out.hpos, hero->boat ? ELayer::SAIL : ELayer::LAND);
+	out.turns[initialNode] = 0;
+	out.moveRemains[initialNode] = hero->movement;
+	if(isHeroPatrolLocked())
+		return;
+
+	pq.push(initialNode);
+	processQueue();
+}
+
+void CPathfinder::updatePaths()
+{
+	std::unordered_set<int3, ShashInt3> changedTiles;
+	std::swap(changedTiles, out.changedTiles);
+
+	/// Every node cost is counted from hero position and movement points so if any of them changed
+	/// or hero is patrolling there is nothing to repair
+	const ui32 initialNode = out.getNodeIndex(out.hpos, hero->boat ? ELayer::SAIL : ELayer::LAND);
+	if(patrolState != PATROL_NONE || out.predecessors[initialNode] != CPathsInfo::NO_NODE || out.turns[initialNode] != 0
+		|| out.moveRemains[initialNode] != hero->movement || !out.locked[initialNode])
+	{
+		calculatePaths();
+		return;
+	}
+
+	auto tileIndex = [&](const int3 & pos) -> size_t
+	{
+		return (pos.x * out.sizes.y + pos.y) * out.sizes.z + pos.z;
+	};
+
+	static const int3 dirs[] = {
+		int3(-1, +1, +0),	int3(0, +1, +0),	int3(+1, +1, +0),
+		int3(-1, +0, +0),	int3(0, +0, +0),	int3(+1, +0, +0),
+		int3(-1, -1, +0),	int3(0, -1, +0),	int3(+1, -1, +0)
+	};
+
+	/// Guards affect all tiles around monster so changed area is expanded by one tile.
+	/// Teleports link distant tiles so any change near them require full recalculation.
+	std::vector<int3> affectedTiles;
+	std::vector<bool> affectedMask(out.sizes.x * out.sizes.y * out.sizes.z, false);
+	for(auto & tile : changedTiles)
+	{
+		for(auto & dir : dirs)
+		{
+			const int3 pos = tile + dir;
+			if(!gs->map->isInTheMap(pos) || affectedMask[tileIndex(pos)])
+				continue;
+
+			if(pos == out.hpos)
+			{
+				calculatePaths();
+				return;
+			}
+			for(const CGObjectInstance * obj : gs->map->getTile(pos).visitableObjects)
+			{
+				if(dynamic_cast<const CGTeleport *>(obj))
+				{
+					calculatePaths();
+					return;
+				}
+			}
+
+			affectedMask[tileIndex(pos)] = true;
+			affectedTiles.push_back(pos);
+		}
+	}
+
+	/// Node is outdated when it's on affected tile or path to it goes through outdated node
+	enum ENodeState : ui8 {UNKNOWN, VALID, OUTDATED};
+	/// Nodes of tile are stored next to each other, so node index divided by number of layers is index of its tile
+	const ui32 nodesCount = out.nodesCount();
+	std::vector<ui8> nodeState(nodesCount, UNKNOWN);
+	std::vector<ui32> chain;
+	for(ui32 i = 0; i < nodesCount; i++)
+	{
+		ui8 state = VALID;
+		chain.clear();
+		for(ui32 node = i; node != CPathsInfo::NO_NODE; node = out.predecessors[node])
+		{
+			if(nodeState[node] != UNKNOWN)
+			{
+				state = nodeState[node];
+				break;
+			}
+
+			chain.push_back(node);
+			if(out.accessible[node] != CGPathNode::NOT_SET && affectedMask[node / ELayer::NUM_LAYERS])
+			{
+				state = OUTDATED;
+				break;
+			}
+		}
+
+		for(auto node : chain)
+			nodeState[node] = state;
+	}
+
+	std::vector<bool> outdatedMask(affectedMask);
+	std::vector<ui32> expandedNodes; //valid nodes that were already expanded, they have to be locked again after repair
+	for(ui32 i = 0; i < nodesCount; i++)
+	{
+		if(out.accessible[i] == CGPathNode::NOT_SET)
+			continue;
+
+		if(nodeState[i] == OUTDATED)
+		{
+			out.resetNode(i, out.accessible[i]);
+			outdatedMask[i / ELayer::NUM_LAYERS] = true;
+		}
+		else if(out.locked[i]) //valid nodes may still get better path through repaired area
+		{
+			out.locked[i] = false;
+			expandedNodes.push_back(i);
+		}
+	}
+	for(auto & pos : affectedTiles)
+		initializeTile(pos);
+
+	/// Restart search from every valid node that was expanded before and border outdated area
+	for(ui32 i = 0; i < nodesCount; i++)
+	{
+		if(out.accessible[i] == CGPathNode::NOT_SET || out.turns[i] == 255 || nodeState[i] != VALID)
+			continue;
+
+		dpIndex = i;
+		dp = out.getNode(i);
+
+		bool isBorder = false;
+		for(auto & dir : dirs)
+		{
+			const int3 pos = dp.coord + dir;
+			if(gs->map->isInTheMap(pos) && outdatedMask[tileIndex(pos)])
+			{
+				isBorder = true;
+				break;
+			}
+		}
+
+		dt = &gs->map->getTile(dp.coord);
+		dtObj = dt->topVisitableObj();
+		if(!isBorder && !vstd::contains_if(dt->visitableObjects, [](const CGObjectInstance * obj)
+			{
+				return dynamic_cast<const CGTeleport *>(obj) != nullptr;
+			}))
+		{
+			continue;
+		}
+
+		destAction = dp.action;
+		if(dpIndex == initialNode)
+			pq.push(dpIndex);
+		else if(destAction >= CGPathNode::TELEPORT_NORMAL)
+		{
+			if(destAction == CGPathNode::TELEPORT_NORMAL)
+				pq.push(dpIndex);
+		}
+		else if(isMovementAfterDestPossible())
+			pq.push(dpIndex);
+	}
+
+	processQueue();
+
+	/// Nodes that weren't improved keep their old expansion, nodes that were improved have been expanded again
+	for(ui32 i : expandedNodes)
+		out.locked[i] = true;
+}
+
+void CPathfinder::processQueue()
 {
 	auto passOneTurnLimitCheck = [&]() -> bool
 	{
 		if(!options.oneTurnSpecialLayersLimit)
 			return true;
 
-		if(cp->layer == ELayer::WATER)
+		if(cp.layer == ELayer::WATER)
 			return false;
-		if(cp->layer == ELayer::AIR)
+		if(cp.layer == ELayer::AIR)
 		{
-			if(options.originalMovementRules && cp->accessible == CGPathNode::ACCESSIBLE)
+			if(options.originalMovementRules && cp.accessible == CGPathNode::ACCESSIBLE)
 				return true;
 			else
 				return false;
@@ -85,42 +259,31 @@ void CPathfinder::calculatePaths()
 
 	auto isBetterWay = [&](int remains, int turn) -> bool
 	{
-		if(dp->turns == 0xff) //we haven't been here before
+		if(dp.turns == 0xff) //we haven't been here before
 			return true;
-		else if(dp->turns > turn)
+		else if(dp.turns > turn)
 			return true;
-		else if(dp->turns >= turn && dp->moveRemains < remains) //this route is faster
+		else if(dp.turns >= turn && dp.moveRemains < remains) //this route is faster
 			return true;
 
 		return false;
 	};
 
-	//logGlobal->info("Calculating paths for hero %s (adress  %d) of player %d", hero->name, hero , hero->tempOwner);
-
-	//initial tile - set cost on 0 and add to the queue
-	CGPathNode * initialNode = out.getNode(out.hpos, hero->boat ? ELayer::SAIL : ELayer::LAND);
-	initialNode->turns = 0;
-	initialNode->moveRemains = hero->movement;
-	if(isHeroPatrolLocked())
-		return;
-
-	pq.push(initialNode);
-	while(!pq.empty())
+	while((cpIndex = pq.pop()) != CPathsInfo::NO_NODE)
 	{
-		cp = pq.top();
-		pq.pop();
-		cp->locked = true;
+		out.locked[cpIndex] = true;
+		cp = out.getNode(cpIndex);
 
-		int movement = cp->moveRemains, turn = cp->turns;
+		int movement = cp.moveRemains, turn = cp.turns;
 		hlp->updateTurnInfo(turn);
 		if(!movement)
 		{
 			hlp->updateTurnInfo(++turn);
-			movement = hlp->getMaxMovePoints(cp->layer);
+			movement = hlp->getMaxMovePoints(cp.layer);
 			if(!passOneTurnLimitCheck())
 				continue;
 		}
-		ct = &gs->map->getTile(cp->coord);
+		ct = &gs->map->getTile(cp.coord);
 		ctObj = ct->topVisitableObj(isSourceInitialPosition());
 
 		//add accessible neighbouring nodes to the queue
@@ -138,18 +301,19 @@ void CPathfinder::calculatePaths()
 					continue;
 
 				/// Check transition without tile accessability rules
-				if(cp->layer != i && !isLayerTransitionPossible(i))
+				if(cp.layer != i && !isLayerTransitionPossible(i))
 					continue;
 
-				dp = out.getNode(neighbour, i);
-				if(dp->locked)
+				dpIndex = out.getNodeIndex(neighbour, i);
+				dp = out.getNode(dpIndex);
+				if(dp.locked)
 					continue;
 
-				if(dp->accessible == CGPathNode::NOT_SET)
+				if(dp.accessible == CGPathNode::NOT_SET)
 					continue;
 
 				/// Check transition using tile accessability rules
-				if(cp->layer != i && !isLayerTransitionPossible())
+				if(cp.layer != i && !isLayerTransitionPossible())
 					continue;
 
 				if(!isMovementToDestPossible())
@@ -157,14 +321,14 @@ void CPathfinder::calculatePaths()
 
 				destAction = getDestAction();
 				int turnAtNextTile = turn, moveAtNextTile = movement;
-				int cost = CPathfinderHelper::getMovementCost(hero, cp->coord, dp->coord, ct, dt, moveAtNextTile, hlp->getTurnInfo());
+				int cost = CPathfinderHelper::getMovementCost(hero, cp.coord, dp.coord, ct, dt, moveAtNextTile, hlp->getTurnInfo());
 				int remains = moveAtNextTile - cost;
 				if(remains < 0)
 				{
 					//occurs rarely, when hero with low movepoints tries to leave the road
 					hlp->updateTurnInfo(++turnAtNextTile);
 					moveAtNextTile = hlp->getMaxMovePoints(i);
-					cost = CPathfinderHelper::getMovementCost(hero, cp->coord, dp->coord, ct, dt, moveAtNextTile, hlp->getTurnInfo()); //cost must be updated, movement points changed :(
+					cost = CPathfinderHelper::getMovementCost(hero, cp.coord, dp.coord, ct, dt, moveAtNextTile, hlp->getTurnInfo()); //cost must be updated, movement points changed :(
 					remains = moveAtNextTile - cost;
 				}
 				if(destAction == CGPathNode::EMBARK || destAction == CGPathNode::DISEMBARK)
@@ -176,16 +340,16 @@ void CPathfinder::calculatePaths()
 				}
 
 				if(isBetterWay(remains, turnAtNextTile) &&
-					((cp->turns == turnAtNextTile && remains) || passOneTurnLimitCheck()))
+					((cp.turns == turnAtNextTile && remains) || passOneTurnLimitCheck()))
 				{
-					assert(dp != cp->theNodeBefore); //two tiles can't point to each other
-					dp->moveRemains = remains;
-					dp->turns = turnAtNextTile;
-					dp->theNodeBefore = cp;
-					dp->action = destAction;
+					assert(dpIndex != out.predecessors[cpIndex]); //two tiles can't point to each other
+					dp.moveRemains = remains;
+					dp.turns = turnAtNextTile;
+					dp.action = destAction;
+					out.setNode(dpIndex, dp, cpIndex);
 
 					if(isMovementAfterDestPossible())
-						pq.push(dp);
+						pq.push(dpIndex);
 				}
 			}
 		} //neighbours loop
@@ -194,37 +358,121 @@ void CPathfinder::calculatePaths()
 		addTeleportExits();
 		for(auto & neighbour : neighbours)
 		{
-			dp = out.getNode(neighbour, cp->layer);
-			if(dp->locked)
+			dpIndex = out.getNodeIndex(neighbour, cp.layer);
+			dp = out.getNode(dpIndex);
+			if(dp.locked)
 				continue;
 			/// TODO: We may consider use invisible exits on FoW border in future
 			/// Useful for AI when at least one tile around exit is visible and passable
 			/// Objects are usually visible on FoW border anyway so it's not cheating.
 			///
 			/// For now it's disabled as it's will cause crashes in movement code.
-			if(dp->accessible == CGPathNode::BLOCKED)
+			if(dp.accessible == CGPathNode::BLOCKED)
 				continue;
 
 			if(isBetterWay(movement, turn))
 			{
 				dtObj = gs->map->getTile(neighbour).topVisitableObj();
 
-				dp->moveRemains = movement;
-				dp->turns = turn;
-				dp->theNodeBefore = cp;
-				dp->action = getTeleportDestAction();
-				if(dp->action == CGPathNode::TELEPORT_NORMAL)
-					pq.push(dp);
+				dp.moveRemains = movement;
+				dp.turns = turn;
+				dp.action = getTeleportDestAction();
+				out.setNode(dpIndex, dp, cpIndex);
+				if(dp.action == CGPathNode::TELEPORT_NORMAL)
+					pq.push(dpIndex);
 			}
 		}
 	} //queue loop
 }
 
+CPathfinder::NodeQueue::NodeQueue(const CPathsInfo & Paths)
+	: paths(Paths), turn(0), remains(-1), count(0)
+{
+}
+
+void CPathfinder::NodeQueue::push(ui32 node)
+{
+	const ui8 nodeTurns = paths.turns[node];
+	if(nodeTurns < turn)
+		selectTurn(nodeTurns);
+
+	if(nodeTurns == turn)
+		addToCurrent(node);
+	else
+	{
+		if(pending.size() <= nodeTurns)
+			pending.resize(nodeTurns + 1);
+
+		pending[nodeTurns].push_back(node);
+	}
+	count++;
+}
+
+ui32 CPathfinder::NodeQueue::pop()
+{
+	while(count)
+	{
+		while(remains >= 0 && current[remains].empty())
+			remains--;
+
+		if(remains < 0)
+		{
+			selectTurn(turn + 1);
+			continue;
+		}
+
+		ui32 node = current[remains].back();
+		current[remains].pop_back();
+		count--;
+
+		/// Node could be added several times before it got best path, only first one is processed
+		if(!paths.locked[node])
+			return node;
+	}
+
+	return CPathsInfo::NO_NODE;
+}
+
+void CPathfinder::NodeQueue::addToCurrent(ui32 node)
+{
+	const ui32 nodeRemains = paths.moveRemains[node];
+	if(current.size() <= nodeRemains)
+		current.resize(nodeRemains + 1);
+
+	current[nodeRemains].push_back(node);
+	vstd::amax(remains, (int)nodeRemains);
+}
+
+void CPathfinder::NodeQueue::selectTurn(ui8 Turn)
+{
+	/// Only happens when nodes of earlier turn added before search started
+	if(Turn < turn)
+	{
+		if(pending.size() <= turn)
+			pending.resize(turn + 1);
+
+		for(; remains >= 0; remains--)
+		{
+			vstd::concatenate(pending[turn], current[remains]);
+			current[remains].clear();
+		}
+	}
+
+	turn = Turn;
+	remains = -1;
+	if(turn < pending.size())
+	{
+		for(auto node : pending[turn])
+			addToCurrent(node);
+		pending[turn].clear();
+	}
+}
+
 void CPathfinder::addNeighbours()
 {
 	neighbours.clear();
 	neighbourTiles.clear();
-	CPathfinderHelper::getNeighbours(gs->map, *ct, cp->coord, neighbourTiles, boost::logic::indeterminate, cp->layer == ELayer::SAIL);
+	CPathfinderHelper::getNeighbours(gs->map, *ct, cp.coord, neighbourTiles, boost::logic::indeterminate, cp.layer == ELayer::SAIL);
 	if(isSourceVisitableObj())
 	{
 		for(int3 tile: neighbourTiles)
@@ -302,10 +550,10 @@ bool CPathfinder::isPatrolMovementAllowed(const int3 & dst) const
 bool CPathfinder::isLayerTransitionPossible(const ELayer destLayer) const
 {
 	/// No layer transition allowed when previous node action is BATTLE
-	if(cp->action == CGPathNode::BATTLE)
+	if(cp.action == CGPathNode::BATTLE)
 		return false;
 
-	switch(cp->layer)
+	switch(cp.layer)
 	{
 	case ELayer::LAND:
 		if(destLayer == ELayer::AIR)
@@ -347,13 +595,13 @@ bool CPathfinder::isLayerTransitionPossible(const ELayer destLayer) const
 
 bool CPathfinder::isLayerTransitionPossible() const
 {
-	switch(cp->layer)
+	switch(cp.layer)
 	{
 	case ELayer::LAND:
-		if(dp->layer == ELayer::SAIL)
+		if(dp.layer == ELayer::SAIL)
 		{
 			/// Cannot enter empty water tile from land -> it has to be visitable
-			if(dp->accessible == CGPathNode::ACCESSIBLE)
+			if(dp.accessible == CGPathNode::ACCESSIBLE)
 				return false;
 		}
 
@@ -361,7 +609,7 @@ bool CPathfinder::isLayerTransitionPossible() const
 
 	case ELayer::SAIL:
 		//tile must be accessible -> exception: unblocked blockvis tiles -> clear but guarded by nearby monster coast
-		if((dp->accessible != CGPathNode::ACCESSIBLE && (dp->accessible != CGPathNode::BLOCKVIS || dt->blocked))
+		if((dp.accessible != CGPathNode::ACCESSIBLE && (dp.accessible != CGPathNode::BLOCKVIS || dt->blocked))
 			|| dt->visitable)  //TODO: passableness problem -> town says it's passable (thus accessible) but we obviously can't disembark onto town gate
 		{
 			return false;
@@ -372,15 +620,15 @@ bool CPathfinder::isLayerTransitionPossible() const
 	case ELayer::AIR:
 		if(options.originalMovementRules)
 		{
-			if((cp->accessible != CGPathNode::ACCESSIBLE &&
-				cp->accessible != CGPathNode::VISITABLE) &&
-				(dp->accessible != CGPathNode::VISITABLE &&
-				 dp->accessible != CGPathNode::ACCESSIBLE))
+			if((cp.accessible != CGPathNode::ACCESSIBLE &&
+				cp.accessible != CGPathNode::VISITABLE) &&
+				(dp.accessible != CGPathNode::VISITABLE &&
+				 dp.accessible != CGPathNode::ACCESSIBLE))
 			{
 				return false;
 			}
 		}
-		else if(cp->accessible != CGPathNode::ACCESSIBLE &&	dp->accessible != CGPathNode::ACCESSIBLE)
+		else if(cp.accessible != CGPathNode::ACCESSIBLE &&	dp.accessible != CGPathNode::ACCESSIBLE)
 		{
 			/// Hero that fly can only land on accessible tiles
 			return false;
@@ -389,7 +637,7 @@ bool CPathfinder::isLayerTransitionPossible() const
 		break;
 
 	case ELayer::WATER:
-		if(dp->accessible != CGPathNode::ACCESSIBLE && dp->accessible != CGPathNode::VISITABLE)
+		if(dp.accessible != CGPathNode::ACCESSIBLE && dp.accessible != CGPathNode::VISITABLE)
 		{
 			/// Hero that walking on water can transit to accessible and visitable tiles
 			/// Though hero can't interact with blocking visit objects while standing on water
@@ -404,17 +652,17 @@ bool CPathfinder::isLayerTransitionPossible() const
 
 bool CPathfinder::isMovementToDestPossible() const
 {
-	if(dp->accessible == CGPathNode::BLOCKED)
+	if(dp.accessible == CGPathNode::BLOCKED)
 		return false;
 
-	switch(dp->layer)
+	switch(dp.layer)
 	{
 	case ELayer::LAND:
-		if(!canMoveBetween(cp->coord, dp->coord))
+		if(!canMoveBetween(cp.coord, dp.coord))
 			return false;
 		if(isSourceGuarded())
 		{
-			if(!(options.originalMovementRules && cp->layer == ELayer::AIR) &&
+			if(!(options.originalMovementRules && cp.layer == ELayer::AIR) &&
 				!isDestinationGuardian()) // Can step into tile of guard
 			{
 				return false;
@@ -424,16 +672,16 @@ bool CPathfinder::isMovementToDestPossible() const
 		break;
 
 	case ELayer::SAIL:
-		if(!canMoveBetween(cp->coord, dp->coord))
+		if(!canMoveBetween(cp.coord, dp.coord))
 			return false;
 		if(isSourceGuarded())
 		{
 			// Hero embarked a boat standing on a guarded tile -> we must allow to move away from that tile
-			if(cp->action != CGPathNode::EMBARK && !isDestinationGuardian())
+			if(cp.action != CGPathNode::EMBARK && !isDestinationGuardian())
 				return false;
 		}
 
-		if(cp->layer == ELayer::LAND)
+		if(cp.layer == ELayer::LAND)
 		{
 			if(!isDestVisitableObj())
 				return false;
@@ -450,7 +698,7 @@ bool CPathfinder::isMovementToDestPossible() const
 		break;
 
 	case ELayer::WATER:
-		if(!canMoveBetween(cp->coord, dp->coord) || dp->accessible != CGPathNode::ACCESSIBLE)
+		if(!canMoveBetween(cp.coord, dp.coord) || dp.accessible != CGPathNode::ACCESSIBLE)
 			return false;
 		if(isDestinationGuarded())
 			return false;
@@ -516,10 +764,10 @@ bool CPathfinder::isMovementAfterDestPossible() const
 CGPathNode::ENodeAction CPathfinder::getDestAction() const
 {
 	CGPathNode::ENodeAction action = CGPathNode::NORMAL;
-	switch(dp->layer)
+	switch(dp.layer)
 	{
 	case ELayer::LAND:
-		if(cp->layer == ELayer::SAIL)
+		if(cp.layer == ELayer::SAIL)
 		{
 			// TODO: Handle dismebark into guarded areaa
 			action = CGPathNode::DISEMBARK;
@@ -608,12 +856,12 @@ CGPathNode::ENodeAction CPathfinder::getTeleportDestAction() const
 
 bool CPathfinder::isSourceInitialPosition() const
 {
-	return cp->coord == out.hpos;
+	return cp.coord == out.hpos;
 }
 
 bool CPathfinder::isSourceVisitableObj() const
 {
-	return isVisitableObj(ctObj, cp->layer);
+	return isVisitableObj(ctObj, cp.layer);
 }
 
 bool CPathfinder::isSourceGuarded() const
@@ -623,7 +871,7 @@ bool CPathfinder::isSourceGuarded() const
 	/// - Map start with hero on guarded tile
 	/// - Dimention door used
 	/// TODO: check what happen when there is several guards
-	if(gs->guardingCreaturePosition(cp->coord).valid() && !isSourceInitialPosition())
+	if(gs->guardingCreaturePosition(cp.coord).valid() && !isSourceInitialPosition())
 	{
 		return true;
 	}
@@ -633,15 +881,15 @@ bool CPathfinder::isSourceGuarded() const
 
 bool CPathfinder::isDestVisitableObj() const
 {
-	return isVisitableObj(dtObj, dp->layer);
+	return isVisitableObj(dtObj, dp.layer);
 }
 
 bool CPathfinder::isDestinationGuarded(const bool ignoreAccessibility) const
 {
 	/// isDestinationGuarded is exception needed for garrisons.
 	/// When monster standing behind garrison it's visitable and guarded at the same time.
-	if(gs->guardingCreaturePosition(dp->coord).valid()
-		&& (ignoreAccessibility || dp->accessible == CGPathNode::BLOCKVIS))
+	if(gs->guardingCreaturePosition(dp.coord).valid()
+		&& (ignoreAccessibility || dp.accessible == CGPathNode::BLOCKVIS))
 	{
 		return true;
 	}
@@ -651,7 +899,7 @@ bool CPathfinder::isDestinationGuarded(const bool ignoreAccessibility) const
 
 bool CPathfinder::isDestinationGuardian() const
 {
-	return gs->guardingCreaturePosition(cp->coord) == dp->coord;
+	return gs->guardingCreaturePosition(cp.coord) == dp.coord;
 }
 
 void CPathfinder::initializePatrol()
@@ -673,45 +921,46 @@ void CPathfinder::initializePatrol()
 
 void CPathfinder::initializeGraph()
 {
-	auto updateNode = [&](int3 pos, ELayer layer, const TerrainTile * tinfo)
-	{
-		auto node = out.getNode(pos, layer);
-		auto accessibility = evaluateAccessibility(pos, tinfo, layer);
-		node->update(pos, layer, accessibility);
-	};
-
 	int3 pos;
 	for(pos.x=0; pos.x < out.sizes.x; ++pos.x)
 	{
 		for(pos.y=0; pos.y < out.sizes.y; ++pos.y)
 		{
 			for(pos.z=0; pos.z < out.sizes.z; ++pos.z)
-			{
-				const TerrainTile * tinfo = &gs->map->getTile(pos);
-				switch(tinfo->terType)
-				{
-				case ETerrainType::ROCK:
-					break;
-
-				case ETerrainType::WATER:
-					updateNode(pos, ELayer::SAIL, tinfo);
-					if(options.useFlying)
-						updateNode(pos, ELayer::AIR, tinfo);
-					if(options.useWaterWalking)
-						updateNode(pos, ELayer::WATER, tinfo);
-					break;
-
-				default:
-					updateNode(pos, ELayer::LAND, tinfo);
-					if(options.useFlying)
-						updateNode(pos, ELayer::AIR, tinfo);
-					break;
-				}
-			}
+				initializeTile(pos);
 		}
 	}
 }
 
+void CPathfinder::initializeTile(const int3 & pos)
+{
+	auto updateNode = [&](ELayer layer, const TerrainTile * tinfo)
+	{
+		out.resetNode(out.getNodeIndex(pos, layer), evaluateAccessibility(pos, tinfo, layer));
+	};
+
+	const TerrainTile * tinfo = &gs->map->getTile(pos);
+	switch(tinfo->terType)
+	{
+	case ETerrainType::ROCK:
+		break;
+
+	case ETerrainType::WATER:
+		updateNode(ELayer::SAIL, tinfo);
+		if(options.useFlying)
+			updateNode(ELayer::AIR, tinfo);
+		if(options.useWaterWalking)
+			updateNode(ELayer::WATER, tinfo);
+		break;
+
+	default:
+		updateNode(ELayer::LAND, tinfo);
+		if(options.useFlying)
+			updateNode(ELayer::AIR, tinfo);
+		break;
+	}
+}
+
 CGPathNode::EAccessibility CPathfinder::evaluateAccessibility(const int3 & pos, const TerrainTile * tinfo, const ELayer layer) const
 {
 	if(tinfo->terType == ETerrainType::ROCK || !FoW[pos.x][pos.y][pos.z])
@@ -859,10 +1108,7 @@ TurnInfo::BonusCache::BonusCache(TBonusListPtr bl)
 TurnInfo::TurnInfo(const CGHeroInstance * Hero, const int turn)
 	: hero(Hero), maxMovePointsLand(-1), maxMovePointsWater(-1)
 {
-	std::stringstream cachingStr;
-	cachingStr << "days_" << turn;
-
-	bonuses = hero->getAllBonuses(Selector::days(turn), nullptr, nullptr, cachingStr.str());
+	bonuses = hero->getAllBonuses(Selector::days(turn), nullptr, nullptr, BonusCacheKey::make(BonusCacheKey::DAYS, 0, 0, turn));
 	bonusCache = make_unique<BonusCache>(bonuses);
 	nativeTerrain = hero->getNativeTerrain();
 }
@@ -1131,23 +1377,9 @@ void CGPathNode::reset()
 	accessible = NOT_SET;
 	moveRemains = 0;
 	turns = 255;
-	theNodeBefore = nullptr;
 	action = UNKNOWN;
 }
 
-void CGPathNode::update(const int3 & Coord, const ELayer Layer, const EAccessibility Accessible)
-{
-	if(layer == ELayer::WRONG)
-	{
-		coord = Coord;
-		layer = Layer;
-	}
-	else
-		reset();
-
-	accessible = Accessible;
-}
-
 bool CGPathNode::reachable() const
 {
 	return turns < 255;
@@ -1174,18 +1406,28 @@ void CGPath::convert(ui8 mode)
 	}
 }
 
+const ui32 CPathsInfo::NO_NODE;
+const size_t CPathsInfo::NODE_SIZE = sizeof(ui32) + sizeof(ui8) + sizeof(ui32)
+	+ sizeof(CGPathNode::EAccessibility) + sizeof(CGPathNode::ENodeAction) + sizeof(ui8);
+
 CPathsInfo::CPathsInfo(const int3 & Sizes)
 	: sizes(Sizes)
 {
 	hero = nullptr;
-	nodes.resize(boost::extents[sizes.x][sizes.y][sizes.z][ELayer::NUM_LAYERS]);
+	const size_t count = sizes.x * sizes.y * sizes.z * ELayer::NUM_LAYERS;
+	moveRemains.resize(count, 0);
+	turns.resize(count, 255);
+	predecessors.resize(count, NO_NODE);
+	accessible.resize(count, CGPathNode::NOT_SET);
+	actions.resize(count, CGPathNode::UNKNOWN);
+	locked.resize(count, false);
 }
 
 CPathsInfo::~CPathsInfo()
 {
 }
 
-const CGPathNode * CPathsInfo::getPathInfo(const int3 & tile) const
+CGPathNode CPathsInfo::getPathInfo(const int3 & tile) const
 {
 	assert(vstd::iswithin(tile.x, 0, sizes.x));
 	assert(vstd::iswithin(tile.y, 0, sizes.y));
@@ -1200,16 +1442,13 @@ bool CPathsInfo::getPath(CGPath & out, const int3 & dst) const
 	boost::unique_lock<boost::mutex> pathLock(pathMx);
 
 	out.nodes.clear();
-	const CGPathNode * curnode = getNode(dst);
-	if(!curnode->theNodeBefore)
+	ui32 curnode = getNodeIndex(dst);
+	if(predecessors[curnode] == NO_NODE)
 		return false;
 
-	while(curnode)
-	{
-		const CGPathNode cpn = * curnode;
-		curnode = curnode->theNodeBefore;
-		out.nodes.push_back(cpn);
-	}
+	for(; curnode != NO_NODE; curnode = predecessors[curnode])
+		out.nodes.push_back(getNode(curnode));
+
 	return true;
 }
 
@@ -1224,16 +1463,251 @@ int CPathsInfo::getDistance(const int3 & tile) const
 		return 255;
 }
 
-const CGPathNode * CPathsInfo::getNode(const int3 & coord) const
+CGPathNode CPathsInfo::getNode(const int3 & coord) const
+{
+	return getNode(getNodeIndex(coord));
+}
+
+CGPathNode CPathsInfo::getNode(ui32 index) const
+{
+	CGPathNode node;
+	if(accessible[index] != CGPathNode::NOT_SET)
+	{
+		ui32 tile = index / ELayer::NUM_LAYERS;
+		node.layer = ELayer(index % ELayer::NUM_LAYERS);
+		node.coord.z = tile % sizes.z;
+		tile /= sizes.z;
+		node.coord.y = tile % sizes.y;
+		node.coord.x = tile / sizes.y;
+	}
+	node.moveRemains = moveRemains[index];
+	node.turns = turns[index];
+	node.accessible = accessible[index];
+	node.action = actions[index];
+	node.locked = locked[index];
+	return node;
+}
+
+size_t CPathsInfo::nodesCount() const
+{
+	return turns.size();
+}
+
+ui32 CPathsInfo::getNodeIndex(const int3 & coord) const
 {
-	auto landNode = &nodes[coord.x][coord.y][coord.z][ELayer::LAND];
-	if(landNode->reachable())
+	const ui32 landNode = getNodeIndex(coord, ELayer::LAND);
+	if(turns[landNode] < 255)
 		return landNode;
 	else
-		return &nodes[coord.x][coord.y][coord.z][ELayer::SAIL];
+		return getNodeIndex(coord, ELayer::SAIL);
+}
+
+ui32 CPathsInfo::getNodeIndex(const int3 & coord, const ELayer layer) const
+{
+	return ((coord.x * sizes.y + coord.y) * sizes.z + coord.z) * ELayer::NUM_LAYERS + layer;
+}
+
+void CPathsInfo::resetNode(ui32 index, const CGPathNode::EAccessibility Accessible)
+{
+	moveRemains[index] = 0;
+	turns[index] = 255;
+	predecessors[index] = NO_NODE;
+	accessible[index] = Accessible;
+	actions[index] = CGPathNode::UNKNOWN;
+	locked[index] = false;
+}
+
+void CPathsInfo::setNode(ui32 index, const CGPathNode & node, ui32 predecessor)
+{
+	moveRemains[index] = node.moveRemains;
+	turns[index] = node.turns;
+	predecessors[index] = predecessor;
+	actions[index] = node.action;
+}
+
+CPathsCache::CPathsCache(CGameState * gs, const int3 & sizes)
+	: gs(gs), sizes(sizes), batching(false), pendingAll(false)
+{
+}
+
+CPathsCache::~CPathsCache()
+{
+}
+
+size_t CPathsCache::capacity() const
+{
+	// keep total size of cached nodes bounded, XL maps fit only few heroes
+	static const size_t PATH_CACHE_MEMORY = 64 * 1024 * 1024;
+	static const size_t PATH_CACHE_MAX_HEROES = 8;
+
+	const size_t pathInfoSize = sizes.x * sizes.y * sizes.z * EPathfindingLayer::NUM_LAYERS * CPathsInfo::NODE_SIZE;
+	size_t ret = PATH_CACHE_MEMORY / std::max<size_t>(pathInfoSize, 1);
+	return vstd::abetween(ret, size_t(1), PATH_CACHE_MAX_HEROES);
+}
+
+void CPathsCache::invalidate()
+{
+	// turn pathfinding info into invalid. It will be regenerated later
+	boost::unique_lock<boost::mutex> cacheLock(mx);
+	pendingAll = true;
+	if(!batching)
+		applyInvalidation();
+}
+
+void CPathsCache::invalidate(const CGObjectInstance * obj)
+{
+	boost::unique_lock<boost::mutex> cacheLock(mx);
+	// teleports link distant tiles and hero own position is start of every path
+	if(dynamic_cast<const CGTeleport *>(obj))
+		pendingAll = true;
+	else
+	{
+		// object may change before batch ends, so its tiles are taken now
+		pendingObjects.insert(obj);
+		for(auto & tile : obj->getBlockedPos())
+			pendingTiles.insert(tile);
+		pendingTiles.insert(obj->visitablePos());
+	}
+	if(!batching)
+		applyInvalidation();
+}
+
+void CPathsCache::invalidate(const std::unordered_set<int3, ShashInt3> & tiles)
+{
+	boost::unique_lock<boost::mutex> cacheLock(mx);
+	pendingTiles.insert(tiles.begin(), tiles.end());
+	if(!batching)
+		applyInvalidation();
+}
+
+void CPathsCache::beginInvalidationBatch()
+{
+	boost::unique_lock<boost::mutex> cacheLock(mx);
+	batching = true;
+}
+
+void CPathsCache::endInvalidationBatch()
+{
+	boost::unique_lock<boost::mutex> cacheLock(mx);
+	batching = false;
+	applyInvalidation();
+}
+
+void CPathsCache::applyInvalidation()
+{
+	if(!pendingAll && pendingTiles.empty() && pendingObjects.empty())
+		return;
+
+	for(auto & pathInfo : paths)
+	{
+		boost::unique_lock<boost::mutex> pathLock(pathInfo->pathMx);
+		if(!pathInfo->hero)
+			continue;
+
+		if(pendingAll || vstd::contains(pendingObjects, pathInfo->hero))
+			pathInfo->hero = nullptr;
+		else
+			pathInfo->changedTiles.insert(pendingTiles.begin(), pendingTiles.end());
+	}
+
+	pendingAll = false;
+	pendingTiles.clear();
+	pendingObjects.clear();
+}
+
+CPathsInfo * CPathsCache::find(const CGHeroInstance * hero, const std::set<const CPathsInfo *> & claimed)
+{
+	auto isFree = [&](const std::unique_ptr<CPathsInfo> & info)
+	{
+		return !vstd::contains(claimed, info.get());
+	};
+
+	auto pathInfo = boost::find_if(paths, [&](const std::unique_ptr<CPathsInfo> & info)
+	{
+		return info->hero == hero;
+	});
+
+	if(pathInfo == paths.end())
+	{
+		// reuse invalidated or least recently used paths before allocating new ones
+		pathInfo = boost::find_if(paths, [&](const std::unique_ptr<CPathsInfo> & info)
+		{
+			return info->hero == nullptr && isFree(info);
+		});
+		if(pathInfo == paths.end() && paths.size() >= capacity())
+		{
+			auto leastRecent = std::find_if(paths.rbegin(), paths.rend(), isFree);
+			if(leastRecent != paths.rend())
+				pathInfo = std::prev(leastRecent.base());
+		}
+
+		if(pathInfo == paths.end())
+			pathInfo = paths.insert(pathInfo, make_unique<CPathsInfo>(sizes));
+
+		boost::unique_lock<boost::mutex> pathLock((*pathInfo)->pathMx);
+		(*pathInfo)->hero = nullptr;
+	}
+
+	paths.splice(paths.begin(), paths, pathInfo);
+	return paths.front().get();
+}
+
+const CPathsInfo * CPathsCache::get(const CGHeroInstance * hero)
+{
+	assert(hero);
+	boost::unique_lock<boost::mutex> cacheLock(mx);
+	applyInvalidation();
+	CPathsInfo * pathInfo = find(hero, std::set<const CPathsInfo *>());
+
+	boost::unique_lock<boost::mutex> pathLock(pathInfo->pathMx);
+	if(pathInfo->hero != hero)
+		calculatePaths(hero, *pathInfo);
+	else if(!pathInfo->changedTiles.empty())
+		updatePaths(hero, *pathInfo);
+
+	return pathInfo;
+}
+
+void CPathsCache::prepare(const std::vector<const CGHeroInstance *> & heroes)
+{
+	boost::unique_lock<boost::mutex> cacheLock(mx);
+	applyInvalidation();
+	std::map<const CGHeroInstance *, CPathsInfo *> uncalculated;
+	std::set<const CGHeroInstance *> processed;
+	std::set<const CPathsInfo *> claimed; //paths reserved by this call still have no hero set until they are calculated
+	std::vector<boost::unique_lock<boost::mutex>> pathLocks;
+
+	for(const CGHeroInstance * hero : heroes)
+	{
+		// heroes beyond cache capacity would evict paths calculated here
+		if(processed.size() >= capacity())
+			break;
+		if(!processed.insert(hero).second)
+			continue;
+
+		CPathsInfo * pathInfo = find(hero, claimed);
+		claimed.insert(pathInfo);
+		pathLocks.emplace_back(pathInfo->pathMx);
+		if(pathInfo->hero != hero)
+			uncalculated[hero] = pathInfo;
+		else if(!pathInfo->changedTiles.empty())
+			updatePaths(hero, *pathInfo);
+	}
+
+	calculatePaths(uncalculated);
+}
+
+void CPathsCache::calculatePaths(const CGHeroInstance * hero, CPathsInfo & out)
+{
+	gs->calculatePaths(hero, out);
+}
+
+void CPathsCache::updatePaths(const CGHeroInstance * hero, CPathsInfo & out)
+{
+	gs->updatePaths(hero, out);
 }
 
-CGPathNode * CPathsInfo::getNode(const int3 & coord, const ELayer layer)
+void CPathsCache::calculatePaths(const std::map<const CGHeroInstance *, CPathsInfo *> & paths)
 {
-	return &nodes[coord.x][coord.y][coord.z][layer];
+	gs->calculatePaths(paths);
 }
@@ -14,7 +14,6 @@
 #include "HeroBonus.h"
 #include "int3.h"
 
-#include <boost/heap/priority_queue.hpp>
 
 class CGHeroInstance;
 class CGObjectInstance;
@@ -51,7 +50,6 @@ struct DLL_LINKAGE CGPathNode
 		BLOCKED //tile can't be entered nor visited
 	};
 
-	CGPathNode * theNodeBefore;
 	int3 coord; //coordinates
 	ui32 moveRemains; //remaining tiles after hero reaches the tile
 	ui8 turns; //how many turns we have to wait before reachng the tile - 0 means current turn
@@ -62,7 +60,6 @@ struct DLL_LINKAGE CGPathNode
 
 	CGPathNode();
 	void reset();
-	void update(const int3 & Coord, const ELayer Layer, const EAccessibility Accessible);
 	bool reachable() const;
 };
 
@@ -79,21 +76,75 @@ struct DLL_LINKAGE CPathsInfo
 {
 	typedef EPathfindingLayer ELayer;
 
+	static const ui32 NO_NODE = 0xffffffff;
+	static const size_t NODE_SIZE; //bytes used by one node in all arrays
+
 	mutable boost::mutex pathMx;
 
 	const CGHeroInstance * hero;
 	int3 hpos;
 	int3 sizes;
-	boost::multi_array<CGPathNode, 4> nodes; //[w][h][level][layer]
+
+	/// Node fields are kept in separate arrays indexed by [w][h][level][layer],
+	/// search reads mostly costs so it doesn't have to load whole nodes into cache.
+	/// Coordinates and layer are not stored, they're known from node index.
+	std::vector<ui32> moveRemains;
+	std::vector<ui8> turns;
+	std::vector<ui32> predecessors; //index of previous node in path or NO_NODE
+	std::vector<CGPathNode::EAccessibility> accessible; //NOT_SET if node is not used for tile terrain
+	std::vector<CGPathNode::ENodeAction> actions;
+	std::vector<ui8> locked;
+	std::unordered_set<int3, ShashInt3> changedTiles; //tiles changed since last calculation, paths around them are repaired by updatePaths
 
 	CPathsInfo(const int3 & Sizes);
 	~CPathsInfo();
-	const CGPathNode * getPathInfo(const int3 & tile) const;
+	CGPathNode getPathInfo(const int3 & tile) const;
 	bool getPath(CGPath & out, const int3 & dst) const;
 	int getDistance(const int3 & tile) const;
-	const CGPathNode * getNode(const int3 & coord) const;
+	CGPathNode getNode(const int3 & coord) const;
+	CGPathNode getNode(ui32 index) const;
+
+	size_t nodesCount() const;
+	ui32 getNodeIndex(const int3 & coord) const; //land node if it's reachable, sail node otherwise
+	ui32 getNodeIndex(const int3 & coord, const ELayer layer) const;
+	void resetNode(ui32 index, const CGPathNode::EAccessibility Accessible);
+	void setNode(ui32 index, const CGPathNode & node, ui32 predecessor); //stores cost and action of node
+};
+
+/// Paths of recently used heroes, most recently used first. Number of kept paths is bounded by memory used by their nodes.
+class DLL_LINKAGE CPathsCache : public boost::noncopyable
+{
+public:
+	CPathsCache(CGameState * gs, const int3 & sizes);
+	virtual ~CPathsCache();
+
+	size_t capacity() const;
+	void invalidate();
+	void invalidate(const CGObjectInstance * obj); //paths are only repaired around tiles occupied by object
+	void invalidate(const std::unordered_set<int3, ShashInt3> & tiles);
+	void beginInvalidationBatch(); //following invalidations are only collected and applied at once by endInvalidationBatch or when paths are requested
+	void endInvalidationBatch();
+	const CPathsInfo * get(const CGHeroInstance * hero);
+	void prepare(const std::vector<const CGHeroInstance *> & heroes); //calculates paths of several heroes at once so get can return them immediately
+
+protected:
+	virtual void calculatePaths(const CGHeroInstance * hero, CPathsInfo & out);
+	virtual void updatePaths(const CGHeroInstance * hero, CPathsInfo & out);
+	virtual void calculatePaths(const std::map<const CGHeroInstance *, CPathsInfo *> & paths);
 
-	CGPathNode * getNode(const int3 & coord, const ELayer layer);
+private:
+	CGameState * gs;
+	int3 sizes;
+	std::list<std::unique_ptr<CPathsInfo>> paths;
+	boost::mutex mx;
+
+	bool batching;
+	bool pendingAll;
+	std::unordered_set<int3, ShashInt3> pendingTiles;
+	std::set<const CGObjectInstance *> pendingObjects; //only compared with heroes of paths, objects may be already deleted
+
+	void applyInvalidation(); //mx must be locked
+	CPathsInfo * find(const CGHeroInstance * hero, const std::set<const CPathsInfo *> & claimed); //never returns claimed paths of other heroes; mx must be locked
 };
 
 class CPathfinder : private CGameInfoCallback
@@ -103,6 +154,7 @@ public:
 
 	CPathfinder(CPathsInfo & _out, CGameState * _gs, const CGHeroInstance * _hero);
 	void calculatePaths(); //calculates possible paths for hero, uses current hero position and movement left; returns pointer to newly allocated CPath or nullptr if path does not exists
+	void updatePaths(); //repairs previously calculated paths around out.changedTiles, falls back to calculatePaths if hero position or movement changed
 
 private:
 	typedef EPathfindingLayer ELayer;
@@ -170,29 +222,39 @@ private:
 	} patrolState;
 	std::unordered_set<int3, ShashInt3> patrolTiles;
 
-	struct NodeComparer
+	/// Bucket queue that return nodes with least turns and then most movement points left first.
+	/// Nodes added during search never have better cost than last returned one,
+	/// so for each turn buckets are only scanned once from most movement points to none.
+	class NodeQueue
 	{
-		bool operator()(const CGPathNode * lhs, const CGPathNode * rhs) const
-		{
-			if(rhs->turns > lhs->turns)
-				return false;
-			else if(rhs->turns == lhs->turns && rhs->moveRemains <= lhs->moveRemains)
-				return false;
-
-			return true;
-		}
-	};
-	boost::heap::priority_queue<CGPathNode *, boost::heap::compare<NodeComparer> > pq;
+	public:
+		NodeQueue(const CPathsInfo & Paths);
+		void push(ui32 node);
+		ui32 pop(); //returns NO_NODE when there is no unlocked nodes left
+
+	private:
+		const CPathsInfo & paths;
+		std::vector<std::vector<ui32>> pending; //[turn] nodes of later turns
+		std::vector<std::vector<ui32>> current; //[moveRemains] nodes of current turn
+		ui8 turn;
+		int remains; //highest bucket in current that may be not empty
+		size_t count;
+
+		void addToCurrent(ui32 node);
+		void selectTurn(ui8 Turn);
+	} pq;
 
 	std::vector<int3> neighbourTiles;
 	std::vector<int3> neighbours;
 
-	CGPathNode * cp; //current (source) path node -> we took it from the queue
-	CGPathNode * dp; //destination node -> it's a neighbour of cp that we consider
+	ui32 cpIndex, dpIndex;
+	CGPathNode cp; //current (source) path node -> we took it from the queue
+	CGPathNode dp; //destination node -> it's a neighbour of cp that we consider, changes are stored back by setNode
 	const TerrainTile * ct, * dt; //tile info for both nodes
 	const CGObjectInstance * ctObj, * dtObj;
 	CGPathNode::ENodeAction destAction;
 
+	void processQueue();
 	void addNeighbours();
 	void addTeleportExits();
 
@@ -215,6 +277,7 @@ private:
 
 	void initializePatrol();
 	void initializeGraph();
+	void initializeTile(const int3 & pos);
 
 	CGPathNode::EAccessibility evaluateAccessibility(const int3 & pos, const TerrainTile * tinfo, const ELayer layer) const;
 	bool isVisitableObj(const CGObjectInstance * obj, const ELayer layer) const;
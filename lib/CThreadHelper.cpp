@@ -24,14 +24,10 @@ CThreadHelper::CThreadHelper(std::vector<std::function<void()> > *Tasks, int Thr
 }
 void CThreadHelper::run()
 {
-	boost::thread_group grupa;
-	std::vector<boost::thread *> thr;
+	boost::thread_group grupa; //owns and deletes created threads
 	for(int i=0;i<threads;i++)
-		thr.push_back(grupa.create_thread(std::bind(&CThreadHelper::processTasks,this)));
+		grupa.create_thread(std::bind(&CThreadHelper::processTasks,this));
 	grupa.join_all();
-
-	for(auto thread : thr)
-		delete thread;
 }
 void CThreadHelper::processTasks()
 {
@@ -26,6 +26,38 @@ public:
 	void run();
 };
 
+/// Calls func for every element of items using given number of threads.
+/// First exception thrown by any call is rethrown after all calls finish.
+template <typename Container, typename Func> void parallelForEach(Container & items, Func func, int threads)
+{
+	boost::mutex errorMx;
+	std::exception_ptr error;
+
+	std::vector<Task> tasks;
+	for(auto & item : items)
+	{
+		tasks.push_back([&]()
+		{
+			try
+			{
+				func(item);
+			}
+			catch(...)
+			{
+				boost::unique_lock<boost::mutex> errorLock(errorMx);
+				if(!error)
+					error = std::current_exception();
+			}
+		});
+	}
+
+	vstd::abetween(threads, 1, std::max<int>(tasks.size(), 1));
+	CThreadHelper(&tasks, threads).run();
+
+	if(error)
+		std::rethrow_exception(error);
+}
+
 template <typename T> inline void setData(T * data, std::function<T()> func)
 {
 	*data = func();
@@ -80,6 +80,156 @@ const std::map<std::string, TPropagatorPtr> bonusPropagatorMap =
 	{"GLOBAL_EFFECT", std::make_shared<CPropagatorNodeType>(CBonusSystemNode::GLOBAL_EFFECTS)}
 }; //untested
 
+///CSelector
+CSelector::CSelector(EOperation op, si32 value):
+	programSize(1)
+{
+	assert(op != CUSTOM && op != AND && op != OR);
+	program[0] = Instruction{op, value};
+}
+
+CSelector::CSelector(const CWillLastTurns &turns):
+	CSelector(WILL_LAST_TURNS, turns.turnsRequested)
+{
+}
+
+CSelector::CSelector(const CWillLastDays &days):
+	CSelector(WILL_LAST_DAYS, days.daysRequested)
+{
+}
+
+CSelector CSelector::And(const CSelector &rhs) const
+{
+	if(programSize == 1 && program[0].op == ALL)
+		return rhs;
+	if(rhs.programSize == 1 && rhs.program[0].op == ALL)
+		return *this;
+	return combine(AND, rhs);
+}
+
+CSelector CSelector::Or(const CSelector &rhs) const
+{
+	if(programSize == 1 && program[0].op == NONE)
+		return rhs;
+	if(rhs.programSize == 1 && rhs.program[0].op == NONE)
+		return *this;
+	return combine(OR, rhs);
+}
+
+CSelector CSelector::combine(EOperation op, const CSelector &rhs) const
+{
+	assert(programSize && rhs.programSize);
+
+	if(1 + programSize + rhs.programSize > MAX_PROGRAM_SIZE)
+	{
+		//lambda may likely outlive "this" (it can be even a temporary) => we copy the OBJECT (not pointer)
+		auto thisCopy = *this;
+		if(op == AND)
+			return CSelector([thisCopy, rhs](const Bonus *b) { return thisCopy(b) && rhs(b); });
+		else
+			return CSelector([thisCopy, rhs](const Bonus *b) { return thisCopy(b) || rhs(b); });
+	}
+
+	CSelector ret;
+	ret.programSize = 1 + programSize + rhs.programSize;
+	ret.program[0] = Instruction{op, ret.programSize};
+	std::copy(program.begin(), program.begin() + programSize, ret.program.begin() + 1);
+	std::copy(rhs.program.begin(), rhs.program.begin() + rhs.programSize, ret.program.begin() + 1 + programSize);
+
+	ret.custom = custom;
+	if(!rhs.custom.empty())
+	{
+		//indices of custom predicates from rhs are shifted by number of predicates taken from this
+		for(auto it = ret.program.begin() + 1 + programSize; it != ret.program.begin() + ret.programSize; it++)
+			if(it->op == CUSTOM)
+				it->value += custom.size();
+		boost::copy(rhs.custom, std::back_inserter(ret.custom));
+	}
+	return ret;
+}
+
+si32 CSelector::getRequiredType() const
+{
+	if(!programSize)
+		return -1;
+	return getRequiredType(0);
+}
+
+si32 CSelector::getRequiredType(ui8 pc) const
+{
+	const Instruction &i = program[pc];
+	switch(i.op)
+	{
+	case TYPE:
+		return i.value;
+	case AND:
+	{
+		//either operand restricting type is enough
+		const si32 lhs = getRequiredType(pc + 1);
+		if(lhs >= 0)
+			return lhs;
+		const Instruction &lhsRoot = program[pc + 1];
+		const ui8 lhsSize = (lhsRoot.op == AND || lhsRoot.op == OR) ? lhsRoot.value : 1;
+		return getRequiredType(pc + 1 + lhsSize);
+	}
+	default:
+		return -1;
+	}
+}
+
+bool CSelector::evaluate(ui8 &pc, const Bonus *b) const
+{
+	const Instruction &i = program[pc++];
+	switch(i.op)
+	{
+	case CUSTOM:
+		return custom[i.value](b);
+	case ALL:
+		return true;
+	case NONE:
+		return false;
+	case TYPE:
+		return b->type == i.value;
+	case SUBTYPE:
+		return b->subtype == i.value;
+	case ADDITIONAL_INFO:
+		return b->additionalInfo == i.value;
+	case SOURCE:
+		return b->source == i.value;
+	case SOURCE_ID:
+		return b->sid == static_cast<ui32>(i.value);
+	case VALUE_TYPE:
+		return b->valType == i.value;
+	case EFFECT_RANGE:
+		return b->effectRange == i.value;
+	case WILL_LAST_TURNS:
+	{
+		CWillLastTurns turns;
+		return turns(i.value)(b);
+	}
+	case WILL_LAST_DAYS:
+	{
+		CWillLastDays days;
+		return days(i.value)(b);
+	}
+	case AND:
+	case OR:
+	{
+		const ui8 end = pc - 1 + i.value;
+		const bool lhs = evaluate(pc, b);
+		if(lhs == (i.op == OR)) //short-circuit, skip rhs
+		{
+			pc = end;
+			return lhs;
+		}
+		return evaluate(pc, b);
+	}
+	default:
+		assert(0);
+		return false;
+	}
+}
+
 ///CBonusProxy
 CBonusProxy::CBonusProxy(const IBonusBearer * Target, CSelector Selector):
 	cachedLast(0), target(Target), selector(Selector), data()
@@ -89,12 +239,14 @@ CBonusProxy::CBonusProxy(const IBonusBearer * Target, CSelector Selector):
 
 TBonusListPtr CBonusProxy::get() const
 {
-	if(CBonusSystemNode::treeChanged != cachedLast || !data)
+	boost::mutex::scoped_lock lock(dataMutex);
+	si64 currentVersion = target->getTreeVersion();
+	if(currentVersion != cachedLast || !data)
 	{
 		//TODO: support limiters
 		data = target->getAllBonuses(selector, nullptr);
 		data->eliminateDuplicates();
-		cachedLast = CBonusSystemNode::treeChanged;
+		cachedLast = currentVersion;
 	}
 	return data;
 }
@@ -104,10 +256,11 @@ const BonusList * CBonusProxy::operator->() const
 	return get().get();
 }
 
-int CBonusSystemNode::treeChanged = 1;
+std::atomic<int> CBonusSystemNode::treeChanged(1);
+std::atomic<ui32> CBonusSystemNode::nodeChangeCounter(0);
 const bool CBonusSystemNode::cachingEnabled = true;
 
-BonusList::BonusList(bool BelongsToTree) : belongsToTree(BelongsToTree)
+BonusList::BonusList(CBonusSystemNode * Owner) : owner(Owner)
 {
 
 }
@@ -116,13 +269,13 @@ BonusList::BonusList(const BonusList &bonusList)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
-	belongsToTree = false;
+	owner = nullptr;
 }
 
 BonusList::BonusList(BonusList&& other):
-	belongsToTree(false)
+	owner(nullptr)
 {
-	std::swap(belongsToTree, other.belongsToTree);
+	std::swap(owner, other.owner);
 	std::swap(bonuses, other.bonuses);
 }
 
@@ -130,14 +283,14 @@ BonusList& BonusList::operator=(const BonusList &bonusList)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
-	belongsToTree = false;
+	owner = nullptr;
 	return *this;
 }
 
 void BonusList::changed()
 {
-    if(belongsToTree)
-		CBonusSystemNode::treeHasChanged();
+	if(owner)
+		owner->nodeHasChanged();
 }
 
 int BonusList::totalValue() const
@@ -258,6 +411,30 @@ void BonusList::getBonuses(BonusList & out, const CSelector &selector, const CSe
 	}
 }
 
+void BonusList::sortByType()
+{
+	std::stable_sort(bonuses.begin(), bonuses.end(), [](const std::shared_ptr<Bonus> &lhs, const std::shared_ptr<Bonus> &rhs)
+	{
+		return lhs->type < rhs->type;
+	});
+}
+
+void BonusList::getBonusesOfType(BonusList &out, Bonus::BonusType type, const CSelector &selector, const CSelector &limit) const
+{
+	auto first = std::lower_bound(bonuses.begin(), bonuses.end(), type, [](const std::shared_ptr<Bonus> &b, Bonus::BonusType t)
+	{
+		return b->type < t;
+	});
+
+	for(auto it = first; it != bonuses.end() && (*it)->type == type; it++)
+	{
+		const Bonus *b = it->get();
+		//same rules as in getBonuses
+		if(selector(b) && ((!limit && b->effectRange == Bonus::NO_LIMIT) || ((bool)limit && limit(b))))
+			out.push_back(*it);
+	}
+}
+
 void BonusList::getAllBonuses(BonusList &out) const
 {
 	for(auto & b : bonuses)
@@ -326,59 +503,51 @@ int IBonusBearer::valOfBonuses(Bonus::BonusType type, const CSelector &selector)
 
 int IBonusBearer::valOfBonuses(Bonus::BonusType type, int subtype) const
 {
-	std::stringstream cachingStr;
-	cachingStr << "type_" << type << "s_" << subtype;
-
 	CSelector s = Selector::type(type);
 	if(subtype != -1)
 		s = s.And(Selector::subtype(subtype));
 
-	return valOfBonuses(s, cachingStr.str());
+	return valOfBonuses(s, BonusCacheKey::make(BonusCacheKey::TYPE_SUBTYPE, type, 0, subtype));
 }
 
-int IBonusBearer::valOfBonuses(const CSelector &selector, const std::string &cachingStr) const
+int IBonusBearer::valOfBonuses(const CSelector &selector, TBonusCacheKey cachingKey) const
 {
 	CSelector limit = nullptr;
-	TBonusListPtr hlp = getAllBonuses(selector, limit, nullptr, cachingStr);
+	TBonusListPtr hlp = getAllBonuses(selector, limit, nullptr, cachingKey);
 	return hlp->totalValue();
 }
-bool IBonusBearer::hasBonus(const CSelector &selector, const std::string &cachingStr) const
+bool IBonusBearer::hasBonus(const CSelector &selector, TBonusCacheKey cachingKey) const
 {
-	return getBonuses(selector, cachingStr)->size() > 0;
+	return getBonuses(selector, cachingKey)->size() > 0;
 }
 
-bool IBonusBearer::hasBonus(const CSelector &selector, const CSelector &limit, const std::string &cachingStr) const
+bool IBonusBearer::hasBonus(const CSelector &selector, const CSelector &limit, TBonusCacheKey cachingKey) const
 {
-	return getBonuses(selector, limit, cachingStr)->size() > 0;
+	return getBonuses(selector, limit, cachingKey)->size() > 0;
 }
 
 bool IBonusBearer::hasBonusOfType(Bonus::BonusType type, int subtype) const
 {
-	std::stringstream cachingStr;
-	cachingStr << "type_" << type << "s_" << subtype;
-
 	CSelector s = Selector::type(type);
 	if(subtype != -1)
 		s = s.And(Selector::subtype(subtype));
 
-	return hasBonus(s, cachingStr.str());
+	return hasBonus(s, BonusCacheKey::make(BonusCacheKey::TYPE_SUBTYPE, type, 0, subtype));
 }
 
-const TBonusListPtr IBonusBearer::getBonuses(const CSelector &selector, const std::string &cachingStr) const
+const TBonusListPtr IBonusBearer::getBonuses(const CSelector &selector, TBonusCacheKey cachingKey) const
 {
-	return getAllBonuses(selector, nullptr, nullptr, cachingStr);
+	return getAllBonuses(selector, nullptr, nullptr, cachingKey);
 }
 
-const TBonusListPtr IBonusBearer::getBonuses(const CSelector &selector, const CSelector &limit, const std::string &cachingStr) const
+const TBonusListPtr IBonusBearer::getBonuses(const CSelector &selector, const CSelector &limit, TBonusCacheKey cachingKey) const
 {
-	return getAllBonuses(selector, limit, nullptr, cachingStr);
+	return getAllBonuses(selector, limit, nullptr, cachingKey);
 }
 
 bool IBonusBearer::hasBonusFrom(Bonus::BonusSource source, ui32 sourceID) const
 {
-	std::stringstream cachingStr;
-	cachingStr << "source_" << source << "id_" << sourceID;
-	return hasBonus(Selector::source(source,sourceID), cachingStr.str());
+	return hasBonus(Selector::source(source,sourceID), BonusCacheKey::make(BonusCacheKey::SOURCE_ID, source, 0, sourceID));
 }
 
 int IBonusBearer::MoraleVal() const
@@ -441,15 +610,13 @@ ui32 IBonusBearer::MaxHealth() const
 
 ui32 IBonusBearer::getMinDamage() const
 {
-	std::stringstream cachingStr;
-	cachingStr << "type_" << Bonus::CREATURE_DAMAGE << "s_0Otype_" << Bonus::CREATURE_DAMAGE << "s_1";
-	return valOfBonuses(Selector::typeSubtype(Bonus::CREATURE_DAMAGE, 0).Or(Selector::typeSubtype(Bonus::CREATURE_DAMAGE, 1)), cachingStr.str());
+	static const CSelector selector = Selector::typeSubtype(Bonus::CREATURE_DAMAGE, 0).Or(Selector::typeSubtype(Bonus::CREATURE_DAMAGE, 1));
+	return valOfBonuses(selector, BonusCacheKey::make(BonusCacheKey::MIN_DAMAGE));
 }
 ui32 IBonusBearer::getMaxDamage() const
 {
-	std::stringstream cachingStr;
-	cachingStr << "type_" << Bonus::CREATURE_DAMAGE << "s_0Otype_" << Bonus::CREATURE_DAMAGE << "s_2";
-	return valOfBonuses(Selector::typeSubtype(Bonus::CREATURE_DAMAGE, 0).Or(Selector::typeSubtype(Bonus::CREATURE_DAMAGE, 2)), cachingStr.str());
+	static const CSelector selector = Selector::typeSubtype(Bonus::CREATURE_DAMAGE, 0).Or(Selector::typeSubtype(Bonus::CREATURE_DAMAGE, 2));
+	return valOfBonuses(selector, BonusCacheKey::make(BonusCacheKey::MAX_DAMAGE));
 }
 
 si32 IBonusBearer::manaLimit() const
@@ -481,26 +648,25 @@ si32 IBonusBearer::magicResistance() const
 ui32 IBonusBearer::Speed(int turn, bool useBind ) const
 {
 	//war machines cannot move
-	if(hasBonus(Selector::type(Bonus::SIEGE_WEAPON).And(Selector::turns(turn))))
+	if(hasBonus(Selector::type(Bonus::SIEGE_WEAPON).And(Selector::turns(turn)), BonusCacheKey::make(BonusCacheKey::TYPE_TURNS, Bonus::SIEGE_WEAPON, 0, turn)))
 	{
 		return 0;
 	}
 	//bind effect check - doesn't influence stack initiative
-	if(useBind && hasBonus(Selector::type(Bonus::BIND_EFFECT).And(Selector::turns(turn))))
+	if(useBind && hasBonus(Selector::type(Bonus::BIND_EFFECT).And(Selector::turns(turn)), BonusCacheKey::make(BonusCacheKey::TYPE_TURNS, Bonus::BIND_EFFECT, 0, turn)))
 	{
 		return 0;
 	}
 
-	return valOfBonuses(Selector::type(Bonus::STACKS_SPEED).And(Selector::turns(turn)));
+	return valOfBonuses(Selector::type(Bonus::STACKS_SPEED).And(Selector::turns(turn)), BonusCacheKey::make(BonusCacheKey::TYPE_TURNS, Bonus::STACKS_SPEED, 0, turn));
 }
 
 bool IBonusBearer::isLiving() const //TODO: theoreticaly there exists "LIVING" bonus in stack experience documentation
 {
-	std::stringstream cachingStr;
-	cachingStr << "type_" << Bonus::UNDEAD << "s_-1Otype_" << Bonus::NON_LIVING << "s_-11type_" << Bonus::SIEGE_WEAPON; //I don't really get what string labels mean?
-	return !hasBonus(Selector::type(Bonus::UNDEAD)
-					.Or(Selector::type(Bonus::NON_LIVING))
-					.Or(Selector::type(Bonus::SIEGE_WEAPON)), cachingStr.str());
+	static const CSelector selector = Selector::type(Bonus::UNDEAD)
+		.Or(Selector::type(Bonus::NON_LIVING))
+		.Or(Selector::type(Bonus::SIEGE_WEAPON));
+	return !hasBonus(selector, BonusCacheKey::make(BonusCacheKey::IS_LIVING));
 }
 
 const std::shared_ptr<Bonus> IBonusBearer::getBonus(const CSelector &selector) const
@@ -568,18 +734,45 @@ void CBonusSystemNode::getAllBonusesRec(BonusList &out) const
 	bonuses.getAllBonuses(out);
 }
 
-const TBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root, const std::string &cachingStr) const
+const TBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root, TBonusCacheKey cachingKey) const
 {
 	bool limitOnUs = (!root || root == this); //caching won't work when we want to limit bonuses against an external node
 	if (CBonusSystemNode::cachingEnabled && limitOnUs)
 	{
-		// Exclusive access for one thread
-		static boost::mutex m;
-		boost::mutex::scoped_lock lock(m);
+		auto selectCached = [&]() -> TBonusListPtr
+		{
+			auto ret = std::make_shared<BonusList>();
+			const si32 requiredType = selector.getRequiredType();
+			if(requiredType >= 0)
+				cachedBonuses.getBonusesOfType(*ret, static_cast<Bonus::BonusType>(requiredType), selector, limit);
+			else
+				cachedBonuses.getBonuses(*ret, selector, limit);
+			return ret;
+		};
+
+		// If this node or any of its ancestors changed (state of a single node or the relations to each other)
+		// then cache all bonus objects. Selector objects doesn't matter.
+		si64 currentVersion = getTreeVersion();
 
-		// If the bonus system tree changes(state of a single node or the relations to each other) then
-		// cache all bonus objects. Selector objects doesn't matter.
-		if (cachedLast != treeChanged)
+		// Up-to-date cache is only read, so any number of threads may query the same node at once.
+		// Limiters must not query bonuses of the node being limited, otherwise this would deadlock.
+		{
+			boost::shared_lock<boost::shared_mutex> lock(cacheMutex);
+			if(cachedLast == currentVersion)
+			{
+				if(cachingKey == 0)
+					return selectCached();
+
+				auto it = cachedRequests.find(cachingKey);
+				if(it != cachedRequests.end())
+					return it->second; //cached list contains bonuses for our query with applied limiters
+			}
+		}
+
+		// Rebuilding cache or storing new request needs exclusive access to this node only
+		boost::unique_lock<boost::shared_mutex> lock(cacheMutex);
+		currentVersion = getTreeVersion();
+		if (cachedLast != currentVersion)
 		{
 			cachedBonuses.clear();
 			cachedRequests.clear();
@@ -588,15 +781,16 @@ const TBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, c
 			getAllBonusesRec(allBonuses);
 			allBonuses.eliminateDuplicates();
 			limitBonuses(allBonuses, cachedBonuses);
+			cachedBonuses.sortByType();
 
-			cachedLast = treeChanged;
+			cachedLast = currentVersion;
 		}
 
-		// If a bonus system request comes with a caching string then look up in the map if there are any
+		// If a bonus system request comes with a caching key then look up in the map if there are any
 		// pre-calculated bonus results. Limiters can't be cached so they have to be calculated.
-		if (cachingStr != "")
+		if (cachingKey != 0)
 		{
-			auto it = cachedRequests.find(cachingStr);
+			auto it = cachedRequests.find(cachingKey);
 			if(it != cachedRequests.end())
 			{
 				//Cached list contains bonuses for our query with applied limiters
@@ -606,12 +800,11 @@ const TBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, c
 
 		//We still don't have the bonuses (didn't returned them from cache)
 		//Perform bonus selection
-		auto ret = std::make_shared<BonusList>();
-		cachedBonuses.getBonuses(*ret, selector, limit);
+		auto ret = selectCached();
 
 		// Save the results in the cache
-		if(cachingStr != "")
-			cachedRequests[cachingStr] = ret;
+		if(cachingKey != 0)
+			cachedRequests[cachingKey] = ret;
 
 		return ret;
 	}
@@ -657,7 +850,7 @@ const TBonusListPtr CBonusSystemNode::getAllBonusesWithoutCaching(const CSelecto
 	return ret;
 }
 
-CBonusSystemNode::CBonusSystemNode() : bonuses(true), exportedBonuses(true), nodeType(UNKNOWN), cachedLast(0)
+CBonusSystemNode::CBonusSystemNode() : bonuses(this), exportedBonuses(this), nodeType(UNKNOWN), cachedLast(0), nodeChanged(0)
 {
 }
 
@@ -666,8 +859,12 @@ CBonusSystemNode::CBonusSystemNode(CBonusSystemNode && other):
 	exportedBonuses(std::move(other.exportedBonuses)),
 	nodeType(other.nodeType),
 	description(other.description),
-	cachedLast(0)
+	cachedLast(0),
+	nodeChanged(0)
 {
+	bonuses.owner = this;
+	exportedBonuses.owner = this;
+
 	std::swap(parents, other.parents);
 	std::swap(children, other.children);
 
@@ -713,7 +910,7 @@ void CBonusSystemNode::attachTo(CBonusSystemNode *parent)
 		newRedDescendant(parent);
 
 	parent->newChildAttached(this);
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::detachFrom(CBonusSystemNode *parent)
@@ -727,7 +924,7 @@ void CBonusSystemNode::detachFrom(CBonusSystemNode *parent)
 
 	parents -= parent;
 	parent->childDetached(this);
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::popBonuses(const CSelector &s)
@@ -767,7 +964,7 @@ void CBonusSystemNode::addNewBonus(const std::shared_ptr<Bonus>& b)
 	assert(!vstd::contains(exportedBonuses, b));
 	exportedBonuses.push_back(b);
 	exportBonus(b);
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::accumulateBonus(const std::shared_ptr<Bonus>& b)
@@ -786,7 +983,7 @@ void CBonusSystemNode::removeBonus(const std::shared_ptr<Bonus>& b)
 		unpropagateBonus(b);
 	else
 		bonuses -= b;
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 bool CBonusSystemNode::actsAsBonusSourceOnly() const
@@ -952,7 +1149,7 @@ void CBonusSystemNode::exportBonus(std::shared_ptr<Bonus> b)
 	else
 		bonuses.push_back(b);
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::exportBonuses()
@@ -1048,6 +1245,27 @@ void CBonusSystemNode::treeHasChanged()
 	treeChanged++;
 }
 
+void CBonusSystemNode::nodeHasChanged()
+{
+	invalidateChildrenNodes(++nodeChangeCounter);
+}
+
+void CBonusSystemNode::invalidateChildrenNodes(ui32 changeCounter)
+{
+	if(nodeChanged == changeCounter) //already visited through another path
+		return;
+
+	nodeChanged = changeCounter;
+
+	for(CBonusSystemNode * child : children)
+		child->invalidateChildrenNodes(changeCounter);
+}
+
+si64 CBonusSystemNode::getTreeVersion() const
+{
+	return (static_cast<si64>(treeChanged) << 32) + static_cast<ui32>(nodeChanged);
+}
+
 int NBonus::valOf(const CBonusSystemNode *obj, Bonus::BonusType type, int subtype)
 {
 	if(obj)
@@ -1136,13 +1354,11 @@ std::shared_ptr<Bonus> Bonus::addPropagator(TPropagatorPtr Propagator)
 
 namespace Selector
 {
-	DLL_LINKAGE CSelectFieldEqual<Bonus::BonusType> type(&Bonus::type);
-	DLL_LINKAGE CSelectFieldEqual<TBonusSubtype> subtype(&Bonus::subtype);
-	DLL_LINKAGE CSelectFieldEqual<si32> info(&Bonus::additionalInfo);
-	DLL_LINKAGE CSelectFieldEqual<Bonus::BonusSource> sourceType(&Bonus::source);
-	DLL_LINKAGE CSelectFieldEqual<Bonus::LimitEffect> effectRange(&Bonus::effectRange);
-	DLL_LINKAGE CWillLastTurns turns;
-	DLL_LINKAGE CWillLastDays days;
+	DLL_LINKAGE CSelectFieldEqual<Bonus::BonusType> type(&Bonus::type, CSelector::TYPE);
+	DLL_LINKAGE CSelectFieldEqual<TBonusSubtype> subtype(&Bonus::subtype, CSelector::SUBTYPE);
+	DLL_LINKAGE CSelectFieldEqual<si32> info(&Bonus::additionalInfo, CSelector::ADDITIONAL_INFO);
+	DLL_LINKAGE CSelectFieldEqual<Bonus::BonusSource> sourceType(&Bonus::source, CSelector::SOURCE);
+	DLL_LINKAGE CSelectFieldEqual<Bonus::LimitEffect> effectRange(&Bonus::effectRange, CSelector::EFFECT_RANGE);
 
 	CSelector DLL_LINKAGE typeSubtype(Bonus::BonusType Type, TBonusSubtype Subtype)
 	{
@@ -1151,29 +1367,39 @@ namespace Selector
 
 	CSelector DLL_LINKAGE typeSubtypeInfo(Bonus::BonusType type, TBonusSubtype subtype, si32 info)
 	{
-		return CSelectFieldEqual<Bonus::BonusType>(&Bonus::type)(type)
-			.And(CSelectFieldEqual<TBonusSubtype>(&Bonus::subtype)(subtype))
-			.And(CSelectFieldEqual<si32>(&Bonus::additionalInfo)(info));
+		return CSelector(CSelector::TYPE, type)
+			.And(CSelector(CSelector::SUBTYPE, subtype))
+			.And(CSelector(CSelector::ADDITIONAL_INFO, info));
 	}
 
 	CSelector DLL_LINKAGE source(Bonus::BonusSource source, ui32 sourceID)
 	{
-		return CSelectFieldEqual<Bonus::BonusSource>(&Bonus::source)(source)
-			.And(CSelectFieldEqual<ui32>(&Bonus::sid)(sourceID));
+		return CSelector(CSelector::SOURCE, source)
+			.And(CSelector(CSelector::SOURCE_ID, static_cast<si32>(sourceID)));
 	}
 
 	CSelector DLL_LINKAGE sourceTypeSel(Bonus::BonusSource source)
 	{
-		return CSelectFieldEqual<Bonus::BonusSource>(&Bonus::source)(source);
+		return CSelector(CSelector::SOURCE, source);
 	}
 
 	CSelector DLL_LINKAGE valueType(Bonus::ValueType valType)
 	{
-		return CSelectFieldEqual<Bonus::ValueType>(&Bonus::valType)(valType);
+		return CSelector(CSelector::VALUE_TYPE, valType);
+	}
+
+	CSelector DLL_LINKAGE turns(int turns)
+	{
+		return CSelector(CSelector::WILL_LAST_TURNS, turns);
+	}
+
+	CSelector DLL_LINKAGE days(int days)
+	{
+		return CSelector(CSelector::WILL_LAST_DAYS, days);
 	}
 
-	DLL_LINKAGE CSelector all([](const Bonus * b){return true;});
-	DLL_LINKAGE CSelector none([](const Bonus * b){return false;});
+	DLL_LINKAGE CSelector all(CSelector::ALL);
+	DLL_LINKAGE CSelector none(CSelector::NONE);
 
 	bool DLL_LINKAGE matchesType(const CSelector &sel, Bonus::BonusType type)
 	{
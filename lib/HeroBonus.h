@@ -26,42 +26,94 @@ typedef std::set<CBonusSystemNode*> TNodes;
 typedef std::set<const CBonusSystemNode*> TCNodes;
 typedef std::vector<CBonusSystemNode *> TNodesVector;
 
-class CSelector : std::function<bool(const Bonus*)>
+/// Identifies cacheable bonus query, results of queries with same non-zero key are shared
+/// Layout: [query kind : 8 bits][bonus type or source : 8 bits][additional info : 16 bits][subtype, id or turn : 32 bits]
+typedef ui64 TBonusCacheKey;
+
+namespace BonusCacheKey
+{
+	enum EQueryKind : ui8
+	{
+		NONE, //query is not cached
+		TYPE_SUBTYPE, TYPE_SUBTYPE_INFO, TYPE_SOURCE, TYPE_TURNS, SOURCE_ID, SOURCE_ID_ANY_RANGE, DAYS,
+		MIN_DAMAGE, MAX_DAMAGE, IS_LIVING, ACTIVE_SPELLS,
+		DISPELLABLE, CURE_DISPELLABLE, HELPFUL_DISPELLABLE
+	};
+
+	inline TBonusCacheKey make(EQueryKind kind, ui8 field = 0, ui16 info = 0, si32 value = 0)
+	{
+		return (static_cast<ui64>(kind) << 56) | (static_cast<ui64>(field) << 48) | (static_cast<ui64>(info) << 32) | static_cast<ui32>(value);
+	}
+}
+
+class CWillLastTurns;
+class CWillLastDays;
+
+/// Bonus predicate compiled into small program of field comparisons and boolean combinators.
+/// Arbitrary functors are still accepted, they are stored aside and called only when reached.
+class DLL_LINKAGE CSelector
 {
-	typedef std::function<bool(const Bonus*)> TBase;
 public:
-	CSelector() {}
+	enum EOperation : ui8
+	{
+		CUSTOM, //value is index of custom predicate
+		ALL, NONE,
+		TYPE, SUBTYPE, ADDITIONAL_INFO, SOURCE, SOURCE_ID, VALUE_TYPE, EFFECT_RANGE, //field equal to value
+		WILL_LAST_TURNS, WILL_LAST_DAYS, //value is number of turns or days
+		AND, OR //value is size of subtree (this instruction and both operands)
+	};
+
+	struct Instruction
+	{
+		EOperation op;
+		si32 value;
+	};
+
+	CSelector() : programSize(0) {}
 	template<typename T>
 	CSelector(const T &t,	//SFINAE trick -> include this c-tor in overload resolution only if parameter is class
 							//(includes functors, lambdas) or function. Without that VC is going mad about ambiguities.
 		typename std::enable_if < boost::mpl::or_ < std::is_class<T>, std::is_function<T >> ::value>::type *dummy = nullptr)
-		: TBase(t)
-	{}
-
-	CSelector(std::nullptr_t)
-	{}
-
-	CSelector And(CSelector rhs) const
-	{
-		//lambda may likely outlive "this" (it can be even a temporary) => we copy the OBJECT (not pointer)
-		auto thisCopy = *this;
-		return [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) && rhs(b); };
-	}
-	CSelector Or(CSelector rhs) const
+		: programSize(1)
 	{
-		auto thisCopy = *this;
-		return [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) || rhs(b); };
+		program[0] = Instruction{CUSTOM, 0};
+		custom.push_back(TCustomPredicate(t));
 	}
 
+	CSelector(std::nullptr_t) : programSize(0) {}
+	CSelector(EOperation op, si32 value = 0);
+	CSelector(const CWillLastTurns &turns);
+	CSelector(const CWillLastDays &days);
+
+	CSelector And(const CSelector &rhs) const;
+	CSelector Or(const CSelector &rhs) const;
+
 	bool operator()(const Bonus *b) const
 	{
-		return TBase::operator()(b);
+		assert(programSize);
+		ui8 pc = 0;
+		return evaluate(pc, b);
 	}
 
 	operator bool() const
 	{
-		return !!static_cast<const TBase&>(*this);
+		return programSize != 0;
 	}
+
+	///returns bonus type every selected bonus must have or -1 if selector may accept bonuses of different types
+	si32 getRequiredType() const;
+
+private:
+	typedef std::function<bool(const Bonus*)> TCustomPredicate;
+	static const ui8 MAX_PROGRAM_SIZE = 15; //longer combinations are nested through custom predicates
+
+	std::array<Instruction, MAX_PROGRAM_SIZE> program; //prefix notation
+	ui8 programSize;
+	std::vector<TCustomPredicate> custom;
+
+	bool evaluate(ui8 &pc, const Bonus *b) const;
+	si32 getRequiredType(ui8 pc) const;
+	CSelector combine(EOperation op, const CSelector &rhs) const;
 };
 
 class DLL_LINKAGE CBonusProxy : public boost::noncopyable
@@ -73,10 +125,11 @@ public:
 
 	const BonusList * operator->() const;
 private:
-	mutable int cachedLast;
+	mutable si64 cachedLast;
 	const IBonusBearer * target;
 	CSelector selector;
 	mutable TBonusListPtr data;
+	mutable boost::mutex dataMutex; //proxy may be queried from several threads, e.g. by battle AI evaluating spells
 };
 
 #define BONUS_TREE_DESERIALIZATION_FIX if(!h.saving && h.smartPointerSerialization) deserializationFix();
@@ -422,7 +475,7 @@ public:
 
 private:
 	TInternalContainer bonuses;
-	bool belongsToTree;
+	CBonusSystemNode * owner; //node whose cache is invalidated on change, nullptr if list is not part of the tree
 	void changed();
 
 public:
@@ -432,7 +485,7 @@ public:
 	typedef TInternalContainer::const_iterator const_iterator;
 	typedef TInternalContainer::iterator iterator;
 
-	BonusList(bool BelongsToTree = false);
+	BonusList(CBonusSystemNode * Owner = nullptr);
 	BonusList(const BonusList &bonusList);
 	BonusList(BonusList && other);
 	BonusList& operator=(const BonusList &bonusList);
@@ -463,6 +516,11 @@ public:
 
 	void getBonuses(BonusList & out, const CSelector &selector) const;
 
+	///sorts bonuses by type, so bonuses of one type form contiguous range
+	void sortByType();
+	///same as getBonuses, but tests only bonuses of given type; list must be sorted by sortByType
+	void getBonusesOfType(BonusList &out, Bonus::BonusType type, const CSelector &selector, const CSelector &limit) const;
+
 	//special find functions
 	std::shared_ptr<Bonus> getFirst(const CSelector &select);
 	const std::shared_ptr<Bonus> getFirst(const CSelector &select) const;
@@ -506,6 +564,8 @@ public:
 	{
 		return bonuses.end();
 	}
+
+	friend class CBonusSystemNode;
 };
 
 // Extensions for BOOST_FOREACH to enable iterating of BonusList objects
@@ -584,12 +644,12 @@ public:
 	// * selector is predicate that tests if HeroBonus matches our criteria
 	// * root is node on which call was made (nullptr will be replaced with this)
 	//interface
-	virtual const TBonusListPtr getAllBonuses(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root = nullptr, const std::string &cachingStr = "") const = 0;
-	int valOfBonuses(const CSelector &selector, const std::string &cachingStr = "") const;
-	bool hasBonus(const CSelector &selector, const std::string &cachingStr = "") const;
-	bool hasBonus(const CSelector &selector, const CSelector &limit, const std::string &cachingStr = "") const;
-	const TBonusListPtr getBonuses(const CSelector &selector, const CSelector &limit, const std::string &cachingStr = "") const;
-	const TBonusListPtr getBonuses(const CSelector &selector, const std::string &cachingStr = "") const;
+	virtual const TBonusListPtr getAllBonuses(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root = nullptr, TBonusCacheKey cachingKey = 0) const = 0;
+	int valOfBonuses(const CSelector &selector, TBonusCacheKey cachingKey = 0) const;
+	bool hasBonus(const CSelector &selector, TBonusCacheKey cachingKey = 0) const;
+	bool hasBonus(const CSelector &selector, const CSelector &limit, TBonusCacheKey cachingKey = 0) const;
+	const TBonusListPtr getBonuses(const CSelector &selector, const CSelector &limit, TBonusCacheKey cachingKey = 0) const;
+	const TBonusListPtr getBonuses(const CSelector &selector, TBonusCacheKey cachingKey = 0) const;
 
 	const std::shared_ptr<Bonus> getBonus(const CSelector &selector) const; //returns any bonus visible on node that matches (or nullptr if none matches)
 
@@ -613,6 +673,8 @@ public:
 
 	si32 manaLimit() const; //maximum mana value for this hero (basically 10*knowledge)
 	int getPrimSkillLevel(PrimarySkill::PrimarySkill id) const;
+
+	virtual si64 getTreeVersion() const = 0; //changes whenever bonuses visible on this bearer may have changed
 };
 
 class DLL_LINKAGE CBonusSystemNode : public IBonusBearer, public boost::noncopyable
@@ -635,17 +697,20 @@ private:
 
 	static const bool cachingEnabled;
 	mutable BonusList cachedBonuses;
-	mutable int cachedLast;
-	static int treeChanged;
+	mutable si64 cachedLast;
+	mutable boost::shared_mutex cacheMutex; //guards cachedBonuses, cachedLast and cachedRequests of this node only, cache hits need only shared access
+	static std::atomic<int> treeChanged; //global counter, invalidates caches of all nodes
+	static std::atomic<ui32> nodeChangeCounter; //source of unique values for nodeChanged
+	std::atomic<ui32> nodeChanged; //changed when this node or any of its ancestors has changed
 
-	// Setting a value to cachingStr before getting any bonuses caches the result for later requests.
-	// This string needs to be unique, that's why it has to be setted in the following manner:
-	// [property key]_[value] => only for selector
-	mutable std::map<std::string, TBonusListPtr > cachedRequests;
+	// Setting a value to cachingKey before getting any bonuses caches the result for later requests.
+	// The key needs to be unique for the selector, see BonusCacheKey::make
+	mutable std::unordered_map<TBonusCacheKey, TBonusListPtr> cachedRequests;
 
 	void getBonusesRec(BonusList &out, const CSelector &selector, const CSelector &limit) const;
 	void getAllBonusesRec(BonusList &out) const;
 	const TBonusListPtr getAllBonusesWithoutCaching(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root = nullptr) const;
+	void invalidateChildrenNodes(ui32 changeCounter);
 
 public:
 	explicit CBonusSystemNode();
@@ -654,7 +719,7 @@ public:
 
 	void limitBonuses(const BonusList &allBonuses, BonusList &out) const; //out will bo populed with bonuses that are not limited here
 	TBonusListPtr limitBonuses(const BonusList &allBonuses) const; //same as above, returns out by val for convienence
-	const TBonusListPtr getAllBonuses(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root = nullptr, const std::string &cachingStr = "") const override;
+	const TBonusListPtr getAllBonuses(const CSelector &selector, const CSelector &limit, const CBonusSystemNode *root = nullptr, TBonusCacheKey cachingKey = 0) const override;
 	void getParents(TCNodes &out) const;  //retrieves list of parent nodes (nodes to inherit bonuses from),
 	const std::shared_ptr<Bonus> getBonusLocalFirst(const CSelector &selector) const;
 
@@ -702,7 +767,11 @@ public:
 	const std::string &getDescription() const;
 	void setDescription(const std::string &description);
 
+	///invalidates cached bonuses of all nodes, use when change can't be attributed to particular node
 	static void treeHasChanged();
+	///invalidates cached bonuses of this node and all its descendants
+	void nodeHasChanged();
+	si64 getTreeVersion() const override;
 
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
@@ -728,15 +797,19 @@ template<typename T>
 class CSelectFieldEqual
 {
 	T Bonus::*ptr;
+	CSelector::EOperation op; //CUSTOM if field has no dedicated operation
 
 public:
-	CSelectFieldEqual(T Bonus::*Ptr)
-		: ptr(Ptr)
+	CSelectFieldEqual(T Bonus::*Ptr, CSelector::EOperation Op = CSelector::CUSTOM)
+		: ptr(Ptr), op(Op)
 	{
 	}
 
 	CSelector operator()(const T &valueToCompareAgainst) const
 	{
+		if(op != CSelector::CUSTOM)
+			return CSelector(op, static_cast<si32>(valueToCompareAgainst));
+
 		auto ptr2 = ptr; //We need a COPY because we don't want to reference this (might be outlived by lambda)
 		return [ptr2, valueToCompareAgainst](const Bonus *bonus) {  return bonus->*ptr2 == valueToCompareAgainst; };
 	}
@@ -945,14 +1018,14 @@ namespace Selector
 	extern DLL_LINKAGE CSelectFieldEqual<si32> info;
 	extern DLL_LINKAGE CSelectFieldEqual<Bonus::BonusSource> sourceType;
 	extern DLL_LINKAGE CSelectFieldEqual<Bonus::LimitEffect> effectRange;
-	extern DLL_LINKAGE CWillLastTurns turns;
-	extern DLL_LINKAGE CWillLastDays days;
 
 	CSelector DLL_LINKAGE typeSubtype(Bonus::BonusType Type, TBonusSubtype Subtype);
 	CSelector DLL_LINKAGE typeSubtypeInfo(Bonus::BonusType type, TBonusSubtype subtype, si32 info);
 	CSelector DLL_LINKAGE source(Bonus::BonusSource source, ui32 sourceID);
 	CSelector DLL_LINKAGE sourceTypeSel(Bonus::BonusSource source);
 	CSelector DLL_LINKAGE valueType(Bonus::ValueType valType);
+	CSelector DLL_LINKAGE turns(int turns); //bonuses that will still be active after given number of battle turns
+	CSelector DLL_LINKAGE days(int days); //bonuses that will still be active after given number of days
 
 	/**
 	 * Selects all bonuses
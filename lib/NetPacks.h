@@ -600,7 +600,6 @@ struct RemoveObject : public CPackForClient
 	RemoveObject(){}
 	RemoveObject(ObjectInstanceID ID){id = ID;};
 	void applyFirstCl(CClient *cl);
-	void applyCl(CClient *cl);
 	DLL_LINKAGE void applyGs(CGameState *gs);
 
 	ObjectInstanceID id;
@@ -1264,6 +1264,8 @@ DLL_LINKAGE void BattleNextRound::applyGs(CGameState *gs)
 
 	for(auto &obst : gs->curB->obstacles)
 		obst->battleTurnPassed();
+
+	gs->curB->stateChanged();
 }
 
 DLL_LINKAGE void BattleSetActiveStack::applyGs(CGameState *gs)
@@ -1315,17 +1317,24 @@ DLL_LINKAGE void BattleTriggerEffect::applyGs(CGameState *gs)
 	default:
 		logNetwork->error("Unrecognized trigger effect type %d", effect);
 	}
+
+	gs->curB->stateChanged();
 }
 
 DLL_LINKAGE void BattleObstaclePlaced::applyGs(CGameState *gs)
 {
 	gs->curB->obstacles.push_back(obstacle);
+
+	gs->curB->stateChanged();
 }
 
 DLL_LINKAGE void BattleUpdateGateState::applyGs(CGameState *gs)
 {
 	if(gs->curB)
+	{
 		gs->curB->si.gateState = state;
+		gs->curB->stateChanged();
+	}
 }
 
 void BattleResult::applyGs(CGameState *gs)
@@ -1392,6 +1401,8 @@ void BattleStackMoved::applyGs(CGameState *gs)
 		}
 	}
 	s->position = dest;
+
+	gs->curB->stateChanged();
 }
 
 DLL_LINKAGE void BattleStackAttacked::applyGs(CGameState *gs)
@@ -1457,6 +1468,8 @@ DLL_LINKAGE void BattleStackAttacked::applyGs(CGameState *gs)
 	//killed summoned creature should be removed like clone
 	if(killed() && vstd::contains(at->state, EBattleStackState::SUMMONED))
 		at->makeGhost();
+
+	gs->curB->stateChanged();
 }
 
 DLL_LINKAGE void BattleAttack::applyGs(CGameState * gs)
@@ -1532,6 +1545,8 @@ DLL_LINKAGE void BattleSpellCast::applyGs(CGameState *gs)
 	const CSpell * spell = SpellID(id).toSpell();
 
 	spell->applyBattle(gs->curB, this);
+
+	gs->curB->stateChanged();
 }
 
 void actualizeEffect(CStack * s, const Bonus & ef)
@@ -1543,7 +1558,7 @@ void actualizeEffect(CStack * s, const Bonus & ef)
 			stackBonus->turnsRemain = std::max(stackBonus->turnsRemain, ef.turnsRemain);
 		}
 	}
-	CBonusSystemNode::treeHasChanged();
+	s->nodeHasChanged();
 }
 
 void actualizeEffect(CStack * s, const std::vector<Bonus> & ef)
@@ -1644,6 +1659,7 @@ DLL_LINKAGE void StacksHealedOrResurrected::applyGs(CGameState *gs)
 				logGlobal->warn("Dead stack %s with positive total HP %d", changedStack->nodeName(), totalHealth);
 
 			changedStack->state.insert(EBattleStackState::ALIVE);
+			gs->curB->stateChanged(); //stack occupies its hexes again
 		}
 
 		changedStack->setHealth(elem);
@@ -1700,6 +1716,8 @@ DLL_LINKAGE void ObstaclesRemoved::applyGs(CGameState *gs)
 			}
 		}
 	}
+
+	gs->curB->stateChanged();
 }
 
 
@@ -1721,6 +1739,7 @@ DLL_LINKAGE void CatapultAttack::applyGs(CGameState *gs)
 			gs->curB->si.wallState[it.attackedPart] =
 			        SiegeInfo::applyDamage(EWallState::EWallState(gs->curB->si.wallState[it.attackedPart]), it.damageDealt);
 		}
+		gs->curB->stateChanged();
 	}
 }
 
@@ -1785,6 +1804,8 @@ DLL_LINKAGE void BattleStacksRemoved::applyGs(CGameState *gs)
 
 		stackIDs.erase(rem_stack);
 	}
+
+	gs->curB->stateChanged();
 }
 
 DLL_LINKAGE void BattleStackAdded::applyGs(CGameState *gs)
@@ -1805,6 +1826,8 @@ DLL_LINKAGE void BattleStackAdded::applyGs(CGameState *gs)
 	gs->curB->stacks.push_back(addedStack);
 
 	newStackID = addedStack->ID;
+
+	gs->curB->stateChanged();
 }
 
 DLL_LINKAGE void BattleSetStackProperty::applyGs(CGameState * gs)
@@ -1846,6 +1869,8 @@ DLL_LINKAGE void BattleSetStackProperty::applyGs(CGameState * gs)
 			break;
 		}
 	}
+
+	gs->curB->stateChanged();
 }
 
 DLL_LINKAGE void PlayerCheated::applyGs(CGameState *gs)
@@ -35,3 +35,47 @@ bool AccessibilityInfo::accessible(BattleHex tile, bool doubleWide, ui8 side) co
 	}
 	return true;
 }
+
+TBattleHexSet AccessibilityInfo::accessibleTiles(bool doubleWide, ui8 side) const
+{
+	TBattleHexSet ret;
+	for(int i = 0; i < GameConstants::BFIELD_SIZE; i++)
+		ret[i] = at(i) == EAccessibility::ACCESSIBLE || (at(i) == EAccessibility::GATE && side == BattleSide::DEFENDER);
+
+	//second hex of double wide stack is behind it, see CStack::getHexes
+	if(doubleWide)
+		ret &= side == BattleSide::ATTACKER ? ret << 1 : ret >> 1;
+	return ret;
+}
+
+namespace
+{
+	struct NeighbourMasks
+	{
+		TBattleHexSet available; //tiles that can be neighbours, see BattleHex::isAvailable
+		TBattleHexSet oddRows; //odd rows are shifted to the right
+
+		NeighbourMasks()
+		{
+			for(si16 i = 0; i < GameConstants::BFIELD_SIZE; i++)
+			{
+				available[i] = BattleHex(i).isAvailable();
+				oddRows[i] = BattleHex(i).getY() % 2;
+			}
+		}
+	};
+}
+
+TBattleHexSet AccessibilityInfo::neighbourTiles(const TBattleHexSet & tiles)
+{
+	static const NeighbourMasks masks;
+	const int W = GameConstants::BFIELD_WIDTH;
+
+	//tiles moved out of their row end up in the first or last column, which is never available
+	const TBattleHexSet odd = tiles & masks.oddRows;
+	const TBattleHexSet even = tiles & ~masks.oddRows;
+	TBattleHexSet ret = (tiles << 1) | (tiles >> 1)
+		| (odd >> (W + 1)) | (odd >> W) | (odd << (W - 1)) | (odd << W)
+		| (even >> W) | (even >> (W - 1)) | (even << W) | (even << (W + 1));
+	return ret & masks.available;
+}
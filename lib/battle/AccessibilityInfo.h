@@ -27,9 +27,13 @@ enum class EAccessibility
 
 
 typedef std::array<EAccessibility, GameConstants::BFIELD_SIZE> TAccessibilityArray;
+typedef std::bitset<GameConstants::BFIELD_SIZE> TBattleHexSet; //one bit per tile, set operations work on whole machine words
 
 struct DLL_LINKAGE AccessibilityInfo : TAccessibilityArray
 {
 	bool accessible(BattleHex tile, const CStack * stack) const; //checks for both tiles if stack is double wide
 	bool accessible(BattleHex tile, bool doubleWide, ui8 side) const; //checks for both tiles if stack is double wide
+	TBattleHexSet accessibleTiles(bool doubleWide, ui8 side) const; //all tiles for which accessible() is true
+
+	static TBattleHexSet neighbourTiles(const TBattleHexSet & tiles); //union of BattleHex::neighbours of all given tiles
 };
@@ -11,6 +11,55 @@
 #include "BattleHex.h"
 #include "../GameConstants.h"
 
+namespace
+{
+	/// Geometry of the battlefield is fixed, so neighbours and distances of all tiles are computed only once
+	struct HexGeometry
+	{
+		std::array<std::array<BattleHex, 6>, GameConstants::BFIELD_SIZE> neighbours;
+		std::array<ui8, GameConstants::BFIELD_SIZE> neighbourCount;
+		std::array<std::array<ui8, GameConstants::BFIELD_SIZE>, GameConstants::BFIELD_SIZE> distances;
+
+		HexGeometry();
+	};
+
+	char calculateDistance(BattleHex hex1, BattleHex hex2)
+	{
+		int y1 = hex1.getY(), y2 = hex2.getY();
+
+		// FIXME: Omit floating point arithmetics
+		int x1 = (hex1.getX() + y1 * 0.5), x2 = (hex2.getX() + y2 * 0.5);
+
+		int xDst = x2 - x1, yDst = y2 - y1;
+
+		if ((xDst >= 0 && yDst >= 0) || (xDst < 0 && yDst < 0))
+			return std::max(std::abs(xDst), std::abs(yDst));
+
+		return std::abs(xDst) + std::abs(yDst);
+	}
+
+	HexGeometry::HexGeometry()
+	{
+		for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+		{
+			std::vector<BattleHex> tiles;
+			for(BattleHex::EDir dir = BattleHex::EDir(0); dir <= BattleHex::EDir(5); dir = BattleHex::EDir(dir+1))
+				BattleHex::checkAndPush(BattleHex(hex).cloneInDirection(dir, false), tiles);
+			boost::copy(tiles, neighbours[hex].begin());
+			neighbourCount[hex] = tiles.size();
+
+			for(si16 other = 0; other < GameConstants::BFIELD_SIZE; other++)
+				distances[hex][other] = calculateDistance(hex, other);
+		}
+	}
+
+	const HexGeometry & geometry()
+	{
+		static const HexGeometry ret;
+		return ret;
+	}
+}
+
 BattleHex::BattleHex() : hex(INVALID) {}
 
 BattleHex::BattleHex(si16 _hex) : hex(_hex) {}
@@ -128,12 +177,22 @@ BattleHex BattleHex::operator+(BattleHex::EDir dir) const
 
 std::vector<BattleHex> BattleHex::neighbouringTiles() const
 {
+	if(isValid())
+		return std::vector<BattleHex>(neighbours().begin(), neighbours().end());
+
 	std::vector<BattleHex> ret;
 	for(EDir dir = EDir(0); dir <= EDir(5); dir = EDir(dir+1))
 		checkAndPush(cloneInDirection(dir, false), ret);
 	return ret;
 }
 
+BattleHex::TNeighbours BattleHex::neighbours() const
+{
+	assert(isValid());
+	const auto & tiles = geometry().neighbours[hex];
+	return TNeighbours(tiles.data(), tiles.data() + geometry().neighbourCount[hex]);
+}
+
 signed char BattleHex::mutualPosition(BattleHex hex1, BattleHex hex2)
 {
 	for(EDir dir = EDir(0); dir <= EDir(5); dir = EDir(dir+1))
@@ -144,17 +203,9 @@ signed char BattleHex::mutualPosition(BattleHex hex1, BattleHex hex2)
 
 char BattleHex::getDistance(BattleHex hex1, BattleHex hex2)
 {
-	int y1 = hex1.getY(), y2 = hex2.getY();
-
-	// FIXME: Omit floating point arithmetics
-	int x1 = (hex1.getX() + y1 * 0.5), x2 = (hex2.getX() + y2 * 0.5);
-
-	int xDst = x2 - x1, yDst = y2 - y1;
-
-	if ((xDst >= 0 && yDst >= 0) || (xDst < 0 && yDst < 0))
-		return std::max(std::abs(xDst), std::abs(yDst));
-
-	return std::abs(xDst) + std::abs(yDst);
+	if(hex1.isValid() && hex2.isValid())
+		return geometry().distances[hex1][hex2];
+	return calculateDistance(hex1, hex2);
 }
 
 void BattleHex::checkAndPush(BattleHex tile, std::vector<BattleHex> & ret)
@@ -27,6 +27,7 @@ struct DLL_LINKAGE BattleHex //TODO: decide if this should be changed to class f
 {
 	si16 hex;
 	static const si16 INVALID = -1;
+	typedef boost::iterator_range<const BattleHex *> TNeighbours;
 	enum EDir
 	{
 		TOP_LEFT,
@@ -57,8 +58,9 @@ struct DLL_LINKAGE BattleHex //TODO: decide if this should be changed to class f
 	BattleHex cloneInDirection(EDir dir, bool hasToBeValid = true) const;
 	BattleHex operator+(EDir dir) const;
 	std::vector<BattleHex> neighbouringTiles() const;
+	TNeighbours neighbours() const; //same tiles as neighbouringTiles, taken from precomputed table without allocation; hex must be valid
 	static signed char mutualPosition(BattleHex hex1, BattleHex hex2);
-	static char getDistance(BattleHex hex1, BattleHex hex2);
+	static char getDistance(BattleHex hex1, BattleHex hex2); //uses precomputed table for valid hexes
 	static void checkAndPush(BattleHex tile, std::vector<BattleHex> & ret);
 	static BattleHex getClosestTile(ui8 side, BattleHex initialPos, std::set<BattleHex> & possibilities); //TODO: vector or set? copying one to another is bad
 
@@ -727,15 +727,22 @@ CStack * BattleInfo::getStack(int stackID, bool onlyAlive)
 	return const_cast<CStack *>(battleGetStackByID(stackID, onlyAlive));
 }
 
+std::atomic<ui64> BattleInfo::lastGeneration(0);
+
 BattleInfo::BattleInfo()
 	: round(-1), activeStack(-1), selectedStack(-1), town(nullptr), tile(-1,-1,-1),
 	battlefieldType(BFieldType::NONE), terrainType(ETerrainType::WRONG),
-	tacticsSide(0), tacticDistance(0)
+	tacticsSide(0), tacticDistance(0), generation(++lastGeneration)
 {
 	setBattle(this);
 	setNodeType(BATTLE);
 }
 
+void BattleInfo::stateChanged()
+{
+	generation = ++lastGeneration;
+}
+
 CArmedInstance * BattleInfo::battleGetArmyObject(ui8 side) const
 {
 	return const_cast<CArmedInstance*>(CBattleInfoEssentials::battleGetArmyObject(side));
@@ -34,6 +34,8 @@ struct DLL_LINKAGE BattleInfo : public CBonusSystemNode, public CBattleInfoCallb
 	ui8 tacticsSide; //which side is requested to play tactics phase
 	ui8 tacticDistance; //how many hexes we can go forward (1 = only hexes adjacent to margin line)
 
+	std::atomic<ui64> generation; //unique number, changed whenever stacks, obstacles or walls change; read by AI threads while netpacks are applied; not serialized
+
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
 		h & sides;
@@ -56,6 +58,8 @@ struct DLL_LINKAGE BattleInfo : public CBonusSystemNode, public CBattleInfoCallb
 	BattleInfo();
 	~BattleInfo(){};
 
+	void stateChanged(); //gives battle new generation, which invalidates cached reachability
+
 	//////////////////////////////////////////////////////////////////////////
 	CStack * getStack(int stackID, bool onlyAlive = true);
 	using CBattleInfoEssentials::battleGetArmyObject;
@@ -89,6 +93,9 @@ struct DLL_LINKAGE BattleInfo : public CBonusSystemNode, public CBattleInfoCallb
 
 	static BattlefieldBI::BattlefieldBI battlefieldTypeToBI(BFieldType bfieldType); //converts above to ERM BI format
 	static int battlefieldTypeToTerrain(int bfieldType); //converts above to ERM BI format
+
+private:
+	static std::atomic<ui64> lastGeneration; //global counter, so generations of different battles never repeat
 };
 
 
@@ -0,0 +1,280 @@
+/*
+ * BattleStateSnapshot.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "BattleStateSnapshot.h"
+#include "../CStack.h"
+#include "CBattleInfoCallback.h"
+#include "CObstacleInstance.h"
+
+bool BattleStateSnapshot::Unit::alive() const
+{
+	return count > 0;
+}
+
+si64 BattleStateSnapshot::Unit::totalHealth() const
+{
+	if(!alive())
+		return 0;
+	return static_cast<si64>(count - 1) * maxHealth + firstHPleft;
+}
+
+BattleHex BattleStateSnapshot::Unit::occupiedHex(BattleHex assumedPos) const
+{
+	if(!doubleWide)
+		return BattleHex::INVALID;
+	return side == BattleSide::ATTACKER ? assumedPos - 1 : assumedPos + 1;
+}
+
+bool BattleStateSnapshot::Unit::coversPos(BattleHex hex) const
+{
+	return position == hex || (doubleWide && occupiedHex(position) == hex);
+}
+
+void BattleStateSnapshot::Unit::damage(si64 amount)
+{
+	const si64 left = totalHealth() - amount;
+	if(left <= 0)
+	{
+		count = 0;
+		firstHPleft = 0;
+	}
+	else
+	{
+		count = (left - 1) / maxHealth + 1;
+		firstHPleft = left - static_cast<si64>(count - 1) * maxHealth;
+	}
+}
+
+BattleStateSnapshot::BattleStateSnapshot(const CBattleInfoCallback * cb)
+{
+	//units move during simulation, so they are placed on terrain only when needed, see accessibility()
+	terrain = cb->getAccesibility();
+	for(auto & tile : terrain)
+	{
+		if(tile == EAccessibility::ALIVE_STACK)
+			tile = EAccessibility::ACCESSIBLE;
+	}
+
+	const auto mySide = cb->battleGetMySide();
+	for(ui8 side : {BattleSide::ATTACKER, BattleSide::DEFENDER})
+	{
+		//player doesn't know which quicksands enemy has discovered, so enemy is assumed to know the same ones
+		const auto perspective = mySide == BattlePerspective::ALL_KNOWING ? static_cast<BattlePerspective::BattlePerspective>(side) : mySide;
+		for(auto & obstacle : cb->battleGetAllObstacles(perspective))
+		{
+			for(BattleHex hex : obstacle->getStoppingTile())
+			{
+				if(hex.isValid())
+					quicksands[side].set(hex);
+			}
+		}
+	}
+
+	for(const CStack * stack : cb->battleAliveStacks())
+	{
+		if(!stack->position.isValid()) //turrets
+			continue;
+
+		Unit unit;
+		unit.stack = stack;
+		unit.side = stack->side;
+		unit.position = stack->position;
+		unit.doubleWide = stack->doubleWide();
+		unit.flying = stack->hasBonusOfType(Bonus::FLYING);
+		unit.shooter = stack->isShooter();
+		unit.meleePenalty = unit.shooter && !stack->hasBonusOfType(Bonus::NO_MELEE_PENALTY);
+		unit.blocksRetaliation = stack->hasBonusOfType(Bonus::BLOCKS_RETALIATION);
+		unit.noRetaliation = stack->hasBonusOfType(Bonus::NO_RETALIATION);
+
+		unit.count = stack->getCount();
+		unit.firstHPleft = stack->getFirstHPleft();
+		unit.maxHealth = std::max<si32>(1, stack->MaxHealth());
+		unit.attack = stack->Attack();
+		unit.defense = stack->Defense();
+		unit.minDamage = stack->getMinDamage();
+		unit.maxDamage = stack->getMaxDamage();
+		unit.speed = stack->Speed(0, true);
+		unit.attacks = 1 + stack->valOfBonuses(Bonus::ADDITIONAL_ATTACK);
+		unit.shots = stack->shots.available();
+		unit.retaliations = stack->ableToRetaliate() ? stack->counterAttacks.available() : 0;
+		units.push_back(unit);
+	}
+}
+
+AccessibilityInfo BattleStateSnapshot::accessibility(const Unit * except) const
+{
+	AccessibilityInfo ret = terrain;
+	for(auto & unit : units)
+	{
+		if(!unit.alive() || &unit == except)
+			continue;
+		for(BattleHex hex : CStack::getHexes(unit.position, unit.doubleWide, unit.side))
+		{
+			if(hex.isValid())
+				ret[hex] = EAccessibility::ALIVE_STACK;
+		}
+	}
+	return ret;
+}
+
+BattleStateSnapshot::Unit * BattleStateSnapshot::find(const CStack * stack)
+{
+	for(auto & unit : units)
+	{
+		if(unit.stack == stack)
+			return unit.alive() ? &unit : nullptr;
+	}
+	return nullptr;
+}
+
+BattleStateSnapshot::THexSet BattleStateSnapshot::reachableHexes(const Unit & unit) const
+{
+	//gate and second hex of double wide unit are handled the same way as in CBattleInfoCallback::makeBFS
+	const THexSet accessible = accessibility(&unit).accessibleTiles(unit.doubleWide, unit.side);
+
+	THexSet ret;
+	ret.set(unit.position);
+	if(unit.flying)
+	{
+		for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+			if(accessible[hex] && BattleHex::getDistance(unit.position, hex) <= unit.speed)
+				ret.set(hex);
+		return ret;
+	}
+
+	//walking unit can't step past the quicksands, but it may leave one it stands on
+	THexSet expanded = ret;
+	for(int step = 0; step < unit.speed && expanded.any(); step++)
+	{
+		const THexSet next = AccessibilityInfo::neighbourTiles(expanded) & accessible & ~ret;
+		ret |= next;
+		expanded = next & ~quicksands[unit.side];
+	}
+	return ret;
+}
+
+bool BattleStateSnapshot::isMeleeAttackPossible(const Unit & attacker, const Unit & defender, BattleHex attackerPos) const
+{
+	for(BattleHex from : {attackerPos, attacker.occupiedHex(attackerPos)})
+	{
+		for(BattleHex to : {defender.position, defender.occupiedHex(defender.position)})
+		{
+			if(from.isValid() && to.isValid() && BattleHex::mutualPosition(from, to) != BattleHex::INVALID)
+				return true;
+		}
+	}
+	return false;
+}
+
+si64 BattleStateSnapshot::estimateDamage(const Unit & attacker, const Unit & defender, bool shooting) const
+{
+	double damage = attacker.count * (attacker.minDamage + attacker.maxDamage) / 2.0;
+
+	//same attack and defense multipliers as in CBattleInfoCallback::calculateDmgRange
+	const int difference = attacker.attack - defender.defense;
+	if(difference > 0)
+		damage *= 1.0 + std::min(0.05 * difference, 4.0);
+	else
+		damage *= 1.0 - std::min(0.025 * (-difference), 0.7);
+
+	if(!shooting && attacker.meleePenalty)
+		damage /= 2;
+
+	return std::max<si64>(1, damage);
+}
+
+void BattleStateSnapshot::move(Unit & unit, BattleHex destination)
+{
+	unit.position = destination;
+}
+
+void BattleStateSnapshot::attack(Unit & attacker, Unit & defender, bool shooting)
+{
+	for(int i = 0; i < attacker.attacks && attacker.alive() && defender.alive(); i++)
+	{
+		if(shooting)
+		{
+			if(attacker.shots <= 0)
+				break;
+			attacker.shots--;
+		}
+
+		defender.damage(estimateDamage(attacker, defender, shooting));
+
+		if(!shooting && defender.alive() && defender.retaliations > 0 && !attacker.blocksRetaliation && !defender.noRetaliation)
+		{
+			defender.retaliations--;
+			attacker.damage(estimateDamage(defender, attacker, false));
+		}
+	}
+}
+
+void BattleStateSnapshot::playGreedyTurn(ui8 side)
+{
+	for(auto & unit : units)
+	{
+		if(unit.side != side || !unit.alive())
+			continue;
+
+		//shooter blocked by adjacent enemy has to fight in melee
+		bool shooting = unit.shooter && unit.shots > 0;
+		for(auto & enemy : units)
+		{
+			if(enemy.side != side && enemy.alive() && isMeleeAttackPossible(unit, enemy, unit.position))
+				shooting = false;
+		}
+		const THexSet reachable = shooting ? THexSet() : reachableHexes(unit);
+
+		Unit * bestTarget = nullptr;
+		BattleHex bestPosition = unit.position;
+		si64 bestDamage = 0;
+		for(auto & enemy : units)
+		{
+			if(enemy.side == side || !enemy.alive())
+				continue;
+
+			BattleHex position = BattleHex::INVALID;
+			if(shooting)
+				position = unit.position;
+			else
+			{
+				for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE && !position.isValid(); hex++)
+				{
+					if(reachable[hex] && isMeleeAttackPossible(unit, enemy, hex))
+						position = hex;
+				}
+			}
+			if(!position.isValid())
+				continue;
+
+			const si64 damage = std::min(estimateDamage(unit, enemy, shooting), enemy.totalHealth());
+			if(damage > bestDamage)
+			{
+				bestTarget = &enemy;
+				bestPosition = position;
+				bestDamage = damage;
+			}
+		}
+
+		if(bestTarget)
+		{
+			move(unit, bestPosition);
+			attack(unit, *bestTarget, shooting);
+		}
+	}
+}
+
+si64 BattleStateSnapshot::value(ui8 side) const
+{
+	si64 ret = 0;
+	for(auto & unit : units)
+		ret += unit.side == side ? unit.totalHealth() : -unit.totalHealth();
+	return ret;
+}
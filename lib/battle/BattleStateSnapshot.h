@@ -0,0 +1,60 @@
+/*
+ * BattleStateSnapshot.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "AccessibilityInfo.h"
+
+class CStack;
+class CBattleInfoCallback;
+
+/// Battle state reduced to plain values, so it can be copied and changed freely when searching several actions ahead.
+/// Everything coming from the bonus system is resolved when the snapshot is taken and doesn't change during simulation.
+class DLL_LINKAGE BattleStateSnapshot
+{
+public:
+	typedef TBattleHexSet THexSet;
+
+	struct Unit
+	{
+		const CStack * stack; //stack this unit was made from, needed to turn simulated actions into real ones
+		ui8 side;
+		BattleHex position;
+		bool doubleWide, flying, shooter;
+		bool meleePenalty, blocksRetaliation, noRetaliation;
+
+		si32 count, firstHPleft, maxHealth; //same meaning as in CHealth
+		si32 attack, defense, minDamage, maxDamage, speed;
+		si32 attacks; //per action, more than one for stacks with ADDITIONAL_ATTACK
+		si32 shots, retaliations; //left in this round
+
+		bool alive() const;
+		si64 totalHealth() const;
+		BattleHex occupiedHex(BattleHex assumedPos) const; //second hex of double wide unit, invalid otherwise
+		bool coversPos(BattleHex hex) const;
+		void damage(si64 amount);
+	};
+
+	std::vector<Unit> units;
+	AccessibilityInfo terrain; //accessibility of battlefield without units: obstacles, walls, gate and side columns
+	std::array<THexSet, 2> quicksands; //stopping obstacles known to each side
+
+	BattleStateSnapshot(const CBattleInfoCallback * cb);
+
+	AccessibilityInfo accessibility(const Unit * except = nullptr) const; //terrain with alive units placed on it
+	Unit * find(const CStack * stack); //nullptr if stack is dead or isn't on battlefield
+	THexSet reachableHexes(const Unit & unit) const; //tiles unit can move to in this round, same as CBattleInfoCallback::battleGetAvailableHexes
+	bool isMeleeAttackPossible(const Unit & attacker, const Unit & defender, BattleHex attackerPos) const;
+
+	si64 estimateDamage(const Unit & attacker, const Unit & defender, bool shooting) const; //average damage, without luck and abilities
+	void move(Unit & unit, BattleHex destination);
+	void attack(Unit & attacker, Unit & defender, bool shooting); //retaliation included
+	void playGreedyTurn(ui8 side); //every unit of side makes its most damaging attack, used to estimate the enemy's reply
+	si64 value(ui8 side) const; //total health of side's units minus total health of enemy units
+};
@@ -94,6 +94,11 @@ static BattleHex WallPartToHex(EWallPart::EWallPart part)
 
 using namespace SiegeStuffThatShouldBeMovedToHandlers;
 
+CBattleInfoCallback::CBattleInfoCallback()
+	: cachedGeneration(0)
+{
+}
+
 ESpellCastProblem::ESpellCastProblem CBattleInfoCallback::battleCanCastSpell(const ISpellCaster * caster, ECastingMode::ECastingMode mode) const
 {
 	RETURN_IF_NOT_BATTLE(ESpellCastProblem::INVALID);
@@ -443,15 +448,18 @@ std::vector<BattleHex> CBattleInfoCallback::battleGetAvailableHexes(const CStack
 
 	if(attackable)
 	{
+		TBattleHexSet available;
+		for(BattleHex hex : ret)
+			available.set(hex);
+
 		auto meleeAttackable = [&](BattleHex hex) -> bool
 		{
 			// Return true if given hex has at least one available neighbour.
 			// Available hexes are already present in ret vector.
-			auto availableNeighbor = boost::find_if(ret, [=] (BattleHex availableHex)
+			return hex.isValid() && vstd::contains_if(hex.neighbours(), [&](BattleHex neighbour)
 			{
-				return BattleHex::mutualPosition(hex, availableHex) >= 0;
+				return available[neighbour];
 			});
-			return availableNeighbor != ret.end();
 		};
 		for(const CStack * otherSt : battleAliveStacks(1-stack->side))
 		{
@@ -516,7 +524,7 @@ bool CBattleInfoCallback::battleCanShoot(const CStack * stack, BattleHex dest) c
 		return false;
 
 	//forgetfulness
-	TBonusListPtr forgetfulList = stack->getBonuses(Selector::type(Bonus::FORGETFULL),"");
+	TBonusListPtr forgetfulList = stack->getBonuses(Selector::type(Bonus::FORGETFULL));
 	if(!forgetfulList->empty())
 	{
 		int forgetful = forgetfulList->valOfBonuses(Selector::type(Bonus::FORGETFULL));
@@ -678,7 +686,7 @@ TDmgRange CBattleInfoCallback::calculateDmgRange(const BattleAttackInfo & info)
 		//todo: set actual percentage in spell bonus configuration instead of just level; requires non trivial backward compatibility handling
 
 		//get list first, total value of 0 also counts
-		TBonusListPtr forgetfulList = info.attackerBonuses->getBonuses(Selector::type(Bonus::FORGETFULL),"");
+		TBonusListPtr forgetfulList = info.attackerBonuses->getBonuses(Selector::type(Bonus::FORGETFULL));
 
 		if(!forgetfulList->empty())
 		{
@@ -847,6 +855,27 @@ std::vector<std::shared_ptr<const CObstacleInstance>> CBattleInfoCallback::getAl
 }
 
 AccessibilityInfo CBattleInfoCallback::getAccesibility() const
+{
+	ui64 generation;
+	{
+		boost::unique_lock<boost::mutex> lock(cacheMutex);
+		generation = validateCache();
+		if(generation && cachedAccessibility)
+			return *cachedAccessibility;
+	}
+
+	auto ret = calculateAccessibility();
+
+	if(generation)
+	{
+		boost::unique_lock<boost::mutex> lock(cacheMutex);
+		if(validateCache() == generation)
+			cachedAccessibility = ret;
+	}
+	return ret;
+}
+
+AccessibilityInfo CBattleInfoCallback::calculateAccessibility() const
 {
 	AccessibilityInfo ret;
 	ret.fill(EAccessibility::ACCESSIBLE);
@@ -964,36 +993,51 @@ ReachabilityInfo CBattleInfoCallback::makeBFS(const AccessibilityInfo &accessibi
 	if(!params.startPosition.isValid()) //if got call for arrow turrets
 		return ret;
 
-	const std::set<BattleHex> quicksands = getStoppers(params.perspective);
-	//const bool twoHexCreature = params.doubleWide;
-
-	std::queue<BattleHex> hexq; //bfs queue
-
-	//first element
-	hexq.push(params.startPosition);
-	ret.distances[params.startPosition] = 0;
-
-	while(!hexq.empty()) //bfs loop
-	{
-		const BattleHex curHex = hexq.front();
-		hexq.pop();
-
+	TBattleHexSet quicksands;
+	for(BattleHex hex : getStoppers(params.perspective))
+		if(hex.isValid())
+			quicksands.set(hex);
+	const TBattleHexSet accessible = accessibility.accessibleTiles(params.doubleWide, params.side);
+
+	//tiles at each distance are found at once, by expanding whole frontier
+	std::array<TBattleHexSet, GameConstants::BFIELD_SIZE> layers;
+	size_t layersCount = 1;
+	layers[0].set(params.startPosition);
+	TBattleHexSet reached = layers[0];
+	TBattleHexSet expanded = layers[0];
+	for(;;)
+	{
+		const TBattleHexSet next = AccessibilityInfo::neighbourTiles(expanded) & accessible & ~reached;
+		if(next.none())
+			break;
+		layers[layersCount++] = next;
+		reached |= next;
 		//walking stack can't step past the quicksands
 		//TODO what if second hex of two-hex creature enters quicksand
-		if(curHex != params.startPosition && vstd::contains(quicksands, curHex))
-			continue;
+		expanded = next & ~quicksands;
+	}
 
-		const int costToNeighbour = ret.distances[curHex] + 1;
-		for(BattleHex neighbour : curHex.neighbouringTiles())
+	//predecessors are chosen in the same order as by queue based search, so paths don't change
+	std::array<BattleHex, GameConstants::BFIELD_SIZE> visitOrder;
+	size_t visited = 0, found = 1;
+	visitOrder[0] = params.startPosition;
+	ret.distances[params.startPosition] = 0;
+	for(size_t distance = 1; distance < layersCount; distance++)
+	{
+		for(const size_t layerEnd = found; visited < layerEnd; visited++)
 		{
-			const bool accessible = accessibility.accessible(neighbour, params.doubleWide, params.side);
-			const int costFoundSoFar = ret.distances[neighbour];
+			const BattleHex curHex = visitOrder[visited];
+			if(curHex != params.startPosition && quicksands[curHex])
+				continue;
 
-			if(accessible && costToNeighbour < costFoundSoFar)
+			for(BattleHex neighbour : curHex.neighbours())
 			{
-				hexq.push(neighbour);
-				ret.distances[neighbour] = costToNeighbour;
-				ret.predecessors[neighbour] = curHex;
+				if(layers[distance][neighbour] && ret.distances[neighbour] == ReachabilityInfo::INFINITE_DIST)
+				{
+					visitOrder[found++] = neighbour;
+					ret.distances[neighbour] = distance;
+					ret.predecessors[neighbour] = curHex;
+				}
 			}
 		}
 	}
@@ -1097,10 +1141,46 @@ ReachabilityInfo CBattleInfoCallback::getReachability(const CStack *stack) const
 
 ReachabilityInfo CBattleInfoCallback::getReachability(const ReachabilityInfo::Parameters &params) const
 {
+	const TReachabilityKey key(params.stack, params.side, params.doubleWide, params.flying, params.knownAccessible, params.startPosition, params.perspective);
+
+	ui64 generation;
+	{
+		boost::unique_lock<boost::mutex> lock(cacheMutex);
+		generation = validateCache();
+		if(generation)
+		{
+			auto it = cachedReachability.find(key);
+			if(it != cachedReachability.end())
+				return it->second;
+		}
+	}
+
+	//computed without lock, so that parallel AI evaluations don't wait for each other
+	ReachabilityInfo ret;
 	if(params.flying)
-		return getFlyingReachability(params);
+		ret = getFlyingReachability(params);
 	else
-		return makeBFS(getAccesibility(params.knownAccessible), params);
+		ret = makeBFS(getAccesibility(params.knownAccessible), params);
+
+	if(generation)
+	{
+		boost::unique_lock<boost::mutex> lock(cacheMutex);
+		if(validateCache() == generation)
+			cachedReachability[key] = ret;
+	}
+	return ret;
+}
+
+ui64 CBattleInfoCallback::validateCache() const
+{
+	const ui64 generation = battleGetGeneration();
+	if(generation != cachedGeneration)
+	{
+		cachedGeneration = generation;
+		cachedAccessibility.reset();
+		cachedReachability.clear();
+	}
+	return generation;
 }
 
 ReachabilityInfo CBattleInfoCallback::getFlyingReachability(const ReachabilityInfo::Parameters &params) const
@@ -1134,18 +1214,26 @@ AttackableTiles CBattleInfoCallback::getPotentiallyAttackableHexes (const CStack
 
 	//FIXME: dragons or cerbers can rotate before attack, making their base hex different (#1124)
 	bool reverse = isToReverse (hex, destinationTile, isAttacker, attacker->doubleWide(), isAttacker);
+	std::vector<BattleHex> doubleWideSurrounding;
+	auto surroundingHexes = [&]() -> BattleHex::TNeighbours
+	{
+		//tiles around single hex attacker are its neighbours, no need to compute them
+		if(!attacker->doubleWide())
+			return hex.neighbours();
+		doubleWideSurrounding = attacker->getSurroundingHexes(attackerPos);
+		return boost::make_iterator_range(doubleWideSurrounding.data(), doubleWideSurrounding.data() + doubleWideSurrounding.size());
+	};
 	if (reverse && attacker->doubleWide())
 	{
 		hex = attacker->occupiedHex(hex); //the other hex stack stands on
 	}
 	if (attacker->hasBonusOfType(Bonus::ATTACKS_ALL_ADJACENT))
 	{
-		boost::copy (attacker->getSurroundingHexes (attackerPos), vstd::set_inserter (at.hostileCreaturePositions));
+		boost::copy (surroundingHexes(), vstd::set_inserter (at.hostileCreaturePositions));
 	}
 	if (attacker->hasBonusOfType(Bonus::THREE_HEADED_ATTACK))
 	{
-		std::vector<BattleHex> hexes = attacker->getSurroundingHexes(attackerPos);
-		for (BattleHex tile : hexes)
+		for (BattleHex tile : surroundingHexes())
 		{
 			if ((BattleHex::mutualPosition(tile, destinationTile) > -1 && BattleHex::mutualPosition (tile, hex) > -1)) //adjacent both to attacker's head and attacked tile
 			{
@@ -1464,10 +1552,9 @@ SpellID CBattleInfoCallback::getRandomBeneficialSpell(CRandomGenerator & rand, c
 
 	for(const SpellID spellID : allPossibleSpells)
 	{
-		std::stringstream cachingStr;
-		cachingStr << "source_" << Bonus::SPELL_EFFECT << "id_" << spellID.num;
+		TBonusCacheKey cachingKey = BonusCacheKey::make(BonusCacheKey::SOURCE_ID_ANY_RANGE, Bonus::SPELL_EFFECT, 0, spellID.num);
 
-		if(subject->hasBonus(Selector::source(Bonus::SPELL_EFFECT, spellID), Selector::all, cachingStr.str())
+		if(subject->hasBonus(Selector::source(Bonus::SPELL_EFFECT, spellID), Selector::all, cachingKey)
 		 //TODO: this ability has special limitations
 		|| spellID.toSpell()->canBeCast(this, ECastingMode::CREATURE_ACTIVE_CASTING, subject) != ESpellCastProblem::OK)
 			continue;
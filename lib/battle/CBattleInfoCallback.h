@@ -38,6 +38,8 @@ public:
 	{
 		RANDOM_GENIE, RANDOM_AIMED
 	};
+	CBattleInfoCallback();
+
 	//battle
 	boost::optional<int> battleIsFinished() const; //return none if battle is ongoing; otherwise the victorious side (0/1) or 2 if it is a draw
 
@@ -108,4 +110,15 @@ protected:
 	ReachabilityInfo makeBFS(const AccessibilityInfo & accessibility, const ReachabilityInfo::Parameters & params) const;
 	ReachabilityInfo makeBFS(const CStack * stack) const; //uses default parameters -> stack position and owner's perspective
 	std::set<BattleHex> getStoppers(BattlePerspective::BattlePerspective whichSidePerspective) const; //get hexes with stopping obstacles (quicksands)
+private:
+	typedef std::tuple<const CStack *, ui8, bool, bool, std::vector<BattleHex>, si16, int> TReachabilityKey; //all fields of ReachabilityInfo::Parameters
+
+	//results of queries made during current battle generation, shared by all threads using this callback
+	mutable boost::mutex cacheMutex;
+	mutable ui64 cachedGeneration;
+	mutable boost::optional<AccessibilityInfo> cachedAccessibility;
+	mutable std::map<TReachabilityKey, ReachabilityInfo> cachedReachability;
+
+	ui64 validateCache() const; //drops outdated results, returns generation to cache new ones for (0 = don't cache); cacheMutex must be locked
+	AccessibilityInfo calculateAccessibility() const;
 };
@@ -234,6 +234,14 @@ const IBonusBearer * CBattleInfoEssentials::getBattleNode() const
 	return getBattle();
 }
 
+ui64 CBattleInfoEssentials::battleGetGeneration() const
+{
+	//stacks and obstacles of battle being set up are added directly, without new generation
+	if(!duringBattle() || getBattle()->round < -1)
+		return 0;
+	return getBattle()->generation;
+}
+
 bool CBattleInfoEssentials::battleCanFlee(PlayerColor player) const
 {
 	RETURN_IF_NOT_BATTLE(false);
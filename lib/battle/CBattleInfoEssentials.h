@@ -38,6 +38,7 @@ class DLL_LINKAGE CBattleInfoEssentials : public virtual CCallbackBase
 protected:
 	bool battleDoWeKnowAbout(ui8 side) const;
 	const IBonusBearer * getBattleNode() const;
+	ui64 battleGetGeneration() const; //changes together with stacks, obstacles or walls; 0 if state may change unnoticed (no battle or battle being set up)
 public:
 	enum EStackOwnership
 	{
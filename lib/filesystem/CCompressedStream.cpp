@@ -29,7 +29,7 @@ si64 CBufferedStream::read(ui8 * data, si64 size)
 
 	std::copy(start, start + toRead, data);
 	position += toRead;
-	return size;
+	return toRead;
 }
 
 si64 CBufferedStream::seek(si64 position)
@@ -165,7 +165,7 @@ si64 CCompressedStream::readMore(ui8 *data, si64 size)
 				throw std::runtime_error(std::string("Decompression error: ") + inflateState->msg);
 		}
 	}
-	while (endLoop == false && inflateState->avail_out != 0 );
+	while (endLoop == false && fileEnded == false && inflateState->avail_out != 0 ); // truncated stream ends without Z_STREAM_END
 
 	decompressed = inflateState->total_out - decompressed;
 
@@ -0,0 +1,167 @@
+/*
+ * BinaryDelta.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "BinaryDelta.h"
+
+namespace
+{
+	const ui8 OP_COPY = 'C'; //ui32 first block, ui32 blocks count
+	const ui8 OP_LITERAL = 'L'; //ui32 length, bytes
+
+	/// Weak checksum of a block that can be moved by one byte in constant time
+	class RollingChecksum
+	{
+		ui32 a, b;
+	public:
+		RollingChecksum(const ui8 * data, ui32 size)
+			: a(0), b(0)
+		{
+			for(ui32 i = 0; i < size; i++)
+			{
+				a += data[i];
+				b += (size - i) * data[i];
+			}
+		}
+
+		void roll(ui8 removed, ui8 added, ui32 size)
+		{
+			a += added - removed;
+			b += a - size * removed;
+		}
+
+		ui32 value() const
+		{
+			return (a & 0xffff) | (b << 16);
+		}
+	};
+
+	void writeInt(std::vector<ui8> & out, ui32 value)
+	{
+		for(int i = 0; i < 4; i++)
+			out.push_back((value >> (8 * i)) & 0xff);
+	}
+
+	ui32 readInt(const std::vector<ui8> & in, size_t & pos)
+	{
+		if(pos + 4 > in.size())
+			throw std::runtime_error("Delta is truncated!");
+
+		ui32 ret = 0;
+		for(int i = 0; i < 4; i++)
+			ret |= static_cast<ui32>(in[pos++]) << (8 * i);
+		return ret;
+	}
+
+	void writeLiteral(std::vector<ui8> & out, const ui8 * data, size_t size)
+	{
+		if(!size)
+			return;
+		out.push_back(OP_LITERAL);
+		writeInt(out, size);
+		out.insert(out.end(), data, data + size);
+	}
+}
+
+std::vector<ui8> BinaryDelta::encode(const std::vector<ui8> & base, const std::vector<ui8> & target)
+{
+	std::vector<ui8> ret;
+	writeInt(ret, target.size());
+
+	const size_t blocks = base.size() / blockSize;
+	std::unordered_map<ui32, ui32> index; //checksum -> first block with it
+	std::vector<bool> filter(1 << 16); //checks most of misses without hashing
+	index.reserve(blocks);
+	for(size_t block = 0; block < blocks; block++)
+	{
+		const ui32 checksum = RollingChecksum(base.data() + block * blockSize, blockSize).value();
+		index.insert(std::make_pair(checksum, block));
+		filter[(checksum ^ (checksum >> 16)) & 0xffff] = true;
+	}
+
+	size_t literalStart = 0, pos = 0;
+	if(blocks && target.size() >= blockSize)
+	{
+		RollingChecksum checksum(target.data(), blockSize);
+		while(pos + blockSize <= target.size())
+		{
+			const ui32 value = checksum.value();
+			if(filter[(value ^ (value >> 16)) & 0xffff])
+			{
+				auto found = index.find(value);
+				if(found != index.end() && !std::memcmp(base.data() + found->second * blockSize, target.data() + pos, blockSize))
+				{
+					//match found, extend it over following blocks
+					ui32 count = 1;
+					while(found->second + count < blocks && pos + (count + 1) * blockSize <= target.size()
+						&& !std::memcmp(base.data() + (found->second + count) * blockSize, target.data() + pos + count * blockSize, blockSize))
+					{
+						count++;
+					}
+
+					writeLiteral(ret, target.data() + literalStart, pos - literalStart);
+					ret.push_back(OP_COPY);
+					writeInt(ret, found->second);
+					writeInt(ret, count);
+
+					pos += count * blockSize;
+					literalStart = pos;
+					if(pos + blockSize <= target.size())
+						checksum = RollingChecksum(target.data() + pos, blockSize);
+					continue;
+				}
+			}
+
+			if(pos + blockSize < target.size())
+				checksum.roll(target[pos], target[pos + blockSize], blockSize);
+			pos++;
+		}
+	}
+	writeLiteral(ret, target.data() + literalStart, target.size() - literalStart);
+	return ret;
+}
+
+std::vector<ui8> BinaryDelta::decode(const std::vector<ui8> & base, const std::vector<ui8> & delta)
+{
+	size_t pos = 0;
+	const size_t size = readInt(delta, pos);
+	std::vector<ui8> ret;
+	ret.reserve(size);
+
+	while(pos < delta.size())
+	{
+		switch(delta[pos++])
+		{
+		case OP_COPY:
+			{
+				const size_t first = readInt(delta, pos);
+				const size_t count = readInt(delta, pos);
+				if((first + count) * blockSize > base.size())
+					throw std::runtime_error("Delta refers to data outside of its base!");
+				ret.insert(ret.end(), base.begin() + first * blockSize, base.begin() + (first + count) * blockSize);
+			}
+			break;
+		case OP_LITERAL:
+			{
+				const size_t length = readInt(delta, pos);
+				if(pos + length > delta.size())
+					throw std::runtime_error("Delta is truncated!");
+				ret.insert(ret.end(), delta.begin() + pos, delta.begin() + pos + length);
+				pos += length;
+			}
+			break;
+		default:
+			throw std::runtime_error("Delta is corrupted!");
+		}
+	}
+
+	if(ret.size() != size)
+		throw std::runtime_error("Delta is corrupted!");
+	return ret;
+}
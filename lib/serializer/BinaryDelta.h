@@ -0,0 +1,21 @@
+/*
+ * BinaryDelta.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+/// Difference between two binary buffers, used to store savegame as changes against an older savegame.
+/// Target is split into parts copied from blocks of base (found with rolling checksum) and literal bytes.
+class DLL_LINKAGE BinaryDelta
+{
+public:
+	static const ui32 blockSize = 1024;
+
+	static std::vector<ui8> encode(const std::vector<ui8> & base, const std::vector<ui8> & target);
+	static std::vector<ui8> decode(const std::vector<ui8> & base, const std::vector<ui8> & delta); //throws!
+};
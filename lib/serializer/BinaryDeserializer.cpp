@@ -10,13 +10,21 @@
 #include "StdInc.h"
 #include "BinaryDeserializer.h"
 #include "../filesystem/FileStream.h"
+#include "../filesystem/CCompressedStream.h"
+#include "../filesystem/CFileInputStream.h"
+#include "../filesystem/CMemoryStream.h"
+#include "BinaryDelta.h"
 
 #include "../registerTypes/RegisterTypes.h"
 
+#include <zlib.h>
+
 extern template void registerTypes<BinaryDeserializer>(BinaryDeserializer & s);
 
-CLoadFile::CLoadFile(const boost::filesystem::path & fname, int minimalVersion)
-	: serializer(this)
+static const size_t readBlockSize = 64 * 1024;
+
+CLoadFile::CLoadFile(const boost::filesystem::path & fname, int minimalVersion, bool loadDeltaBase)
+	: serializer(this), readBuffer(readBlockSize), readPos(0), readEnd(0), fileSize(0), loadDeltaBase(loadDeltaBase)
 {
 	registerTypes(serializer);
 	openNextFile(fname, minimalVersion);
@@ -28,10 +36,53 @@ CLoadFile::~CLoadFile()
 
 int CLoadFile::read(void * data, unsigned size)
 {
-	sfile->read((char*)data,size);
+	if(readEnd - readPos >= size) //most reads are served directly from the buffer
+	{
+		std::memcpy(data, readBuffer.data() + readPos, size);
+		readPos += size;
+		return size;
+	}
+
+	auto dest = static_cast<ui8 *>(data);
+	const size_t buffered = readEnd - readPos;
+	std::memcpy(dest, readBuffer.data() + readPos, buffered);
+	dest += buffered;
+	const size_t missing = size - buffered;
+	readPos = readEnd = 0;
+
+	if(missing >= readBuffer.size()) //big blocks are not worth copying twice
+	{
+		if(readFromSource(dest, missing) != missing)
+			THROW_FORMAT("Error: unexpected end of file %s!", fName);
+	}
+	else
+	{
+		readEnd = readFromSource(readBuffer.data(), readBuffer.size());
+		if(readEnd < missing)
+			THROW_FORMAT("Error: unexpected end of file %s!", fName);
+
+		std::memcpy(dest, readBuffer.data(), missing);
+		readPos = missing;
+	}
+	return size;
+}
+
+size_t CLoadFile::readFromSource(ui8 * data, size_t size)
+{
+	if(dataStream)
+		return dataStream->read(data, size);
+
+	size = std::min<size_t>(size, fileSize - sfile->tellg());
+	sfile->read((char *)data, size);
 	return size;
 }
 
+si64 CLoadFile::tell()
+{
+	si64 sourcePos = dataStream ? dataStream->tell() : static_cast<si64>(sfile->tellg());
+	return sourcePos - (readEnd - readPos);
+}
+
 void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalVersion)
 {
 	assert(!serializer.reverseEndianess);
@@ -40,15 +91,20 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalV
 	try
 	{
 		fName = fname.string();
+		dataStream = nullptr;
+		deltaBase.clear();
+		readPos = readEnd = 0;
 		sfile = make_unique<FileStream>(fname, std::ios::in | std::ios::binary);
 		sfile->exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
 
 		if(!(*sfile))
 			THROW_FORMAT("Error: cannot open to read %s!", fName);
 
+		fileSize = boost::filesystem::file_size(fname);
+
 		//we can read
 		char buffer[4];
-		sfile->read(buffer, 4);
+		read(buffer, 4);
 		if(std::memcmp(buffer,"VCMI",4))
 			THROW_FORMAT("Error: not a VCMI file(%s)!", fName);
 
@@ -72,6 +128,20 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalV
 			else
 				THROW_FORMAT("Error: too new file format (%s)!", fName);
 		}
+
+		if(serializer.fileVersion >= 778)
+		{
+			ui8 flags = 0;
+			serializer & flags;
+			if(flags & SAVE_COMPRESSED)
+			{
+				si64 offset = tell();
+				dataStream = make_unique<CCompressedStream>(make_unique<CFileInputStream>(fname, offset, fileSize - offset), false);
+				readPos = readEnd = 0; //buffered data is still compressed
+			}
+			if(flags & SAVE_DELTA)
+				loadDelta();
+		}
 	}
 	catch(...)
 	{
@@ -80,16 +150,50 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalV
 	}
 }
 
+void CLoadFile::loadDelta()
+{
+	std::string baseName;
+	ui32 baseSize, baseChecksum;
+	std::vector<ui8> delta;
+	serializer & baseName & baseSize & baseChecksum & delta;
+
+	boost::filesystem::path basePath(baseName);
+	if(basePath.is_relative())
+		basePath = boost::filesystem::path(fName).parent_path() / basePath;
+	deltaBase = basePath;
+	if(!loadDeltaBase)
+		return;
+
+	if(!boost::filesystem::exists(basePath))
+		THROW_FORMAT("Error: %s is saved as difference against %s, which is missing!", fName % basePath.string());
+
+	std::vector<ui8> base(baseSize);
+	{
+		CLoadFile baseFile(basePath, serializer.fileVersion);
+		baseFile.read(base.data(), baseSize);
+	}
+	if(crc32(0, base.data(), baseSize) != baseChecksum)
+		THROW_FORMAT("Error: %s was modified after %s has been saved against it!", basePath.string() % fName);
+
+	deltaData = BinaryDelta::decode(base, delta);
+	dataStream = make_unique<CMemoryStream>(deltaData.data(), deltaData.size());
+	readPos = readEnd = 0;
+}
+
 void CLoadFile::reportState(vstd::CLoggerBase * out)
 {
 	out->debug("CLoadFile");
 	if(!!sfile && *sfile)
-		out->debug("\tOpened %s Position: %d", fName, sfile->tellg());
+		out->debug("\tOpened %s Position: %d", fName, tell());
 }
 
 void CLoadFile::clear()
 {
+	dataStream = nullptr;
+	deltaData.clear();
+	deltaBase.clear();
 	sfile = nullptr;
+	readPos = readEnd = 0;
 	fName.clear();
 	serializer.fileVersion = 0;
 }
@@ -16,6 +16,7 @@
 
 class CStackInstance;
 class FileStream;
+class CInputStream;
 
 class DLL_LINKAGE CLoaderBase
 {
@@ -205,7 +206,28 @@ public:
 	void load(T &data)
 	{
 		ui32 size = ARRAY_COUNT(data);
-		for(ui32 i = 0; i < size; i++)
+		loadArray(data, size);
+	}
+
+	template < typename T, typename std::enable_if < is_bulk_serializeable<T>::value, int  >::type = 0 >
+	void loadArray(T * data, ui32 length)
+	{
+		if(!length)
+			return;
+
+		this->read(data, sizeof(T) * length);
+		if(reverseEndianess && sizeof(T) > 1)
+		{
+			char * dataPtr = (char*)data;
+			for(ui32 i = 0; i < length; i++, dataPtr += sizeof(T))
+				std::reverse(dataPtr, dataPtr + sizeof(T));
+		}
+	}
+
+	template < typename T, typename std::enable_if < !is_bulk_serializeable<T>::value, int  >::type = 0 >
+	void loadArray(T * data, ui32 length)
+	{
+		for(ui32 i = 0; i < length; i++)
 			load(data[i]);
 	}
 
@@ -239,8 +261,7 @@ public:
 	{
 		READ_CHECK_U32(length);
 		data.resize(length);
-		for(ui32 i=0;i<length;i++)
-			load( data[i]);
+		loadArray(data.data(), length);
 	}
 
 	template < typename T, typename std::enable_if < std::is_pointer<T>::value, int  >::type = 0 >
@@ -395,8 +416,7 @@ public:
 	template <typename T, size_t N>
 	void load(std::array<T, N> &data)
 	{
-		for(ui32 i = 0; i < N; i++)
-			load( data[i] );
+		loadArray(data.data(), N);
 	}
 	template <typename T>
 	void load(std::set<T> &data)
@@ -515,10 +535,14 @@ public:
 
 	std::string fName;
 	std::unique_ptr<FileStream> sfile;
+	std::unique_ptr<CInputStream> dataStream; //used instead of sfile for compressed and delta saves
+	boost::filesystem::path deltaBase; //file that delta save is stored as difference against, empty for other files
 
-	CLoadFile(const boost::filesystem::path & fname, int minimalVersion = SERIALIZATION_VERSION); //throws!
+	/// With loadDeltaBase set to false, only deltaBase of delta save is read and its data can't be loaded
+	CLoadFile(const boost::filesystem::path & fname, int minimalVersion = SERIALIZATION_VERSION, bool loadDeltaBase = true); //throws!
 	~CLoadFile();
 	int read(void * data, unsigned size) override; //throws!
+	si64 tell(); //position of the next byte to be read by serializer
 
 	void openNextFile(const boost::filesystem::path & fname, int minimalVersion); //throws!
 	void clear();
@@ -532,4 +556,15 @@ public:
 		serializer & t;
 		return * this;
 	}
+
+private:
+	std::vector<ui8> readBuffer; //file is read in blocks, so serializing primitives doesn't go through the stream
+	size_t readPos; //index of the next byte in readBuffer
+	size_t readEnd; //end of valid data in readBuffer
+	si64 fileSize;
+	std::vector<ui8> deltaData; //contents of delta save, restored from its base
+	bool loadDeltaBase;
+
+	size_t readFromSource(ui8 * data, size_t size);
+	void loadDelta(); //throws!
 };
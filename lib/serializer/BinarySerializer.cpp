@@ -10,30 +10,63 @@
 #include "StdInc.h"
 #include "BinarySerializer.h"
 #include "../filesystem/FileStream.h"
+#include "../ScopeGuard.h"
 
 #include "../registerTypes/RegisterTypes.h"
 
+#include <zlib.h>
+
 extern template void registerTypes<BinarySerializer>(BinarySerializer & s);
 
-CSaveFile::CSaveFile(const boost::filesystem::path &fname)
-	: serializer(this)
+static const int deflateBlockSize = 64 * 1024;
+
+CSaveFile::CSaveFile(const boost::filesystem::path &fname, bool compress, bool delta)
+	: serializer(this), deflateState(nullptr)
 {
 	registerTypes(serializer);
-	openNextFile(fname);
+	openNextFile(fname, compress, delta);
 }
 
 CSaveFile::~CSaveFile()
 {
+	try
+	{
+		clear();
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Failed to finish writing %s: %s", fName.string(), e.what());
+	}
 }
 
 int CSaveFile::write(const void * data, unsigned size)
 {
-	sfile->write((char *)data,size);
+	if(deflateState)
+		deflateData(data, size, Z_NO_FLUSH);
+	else
+		sfile->write((char *)data,size);
 	return size;
 }
 
-void CSaveFile::openNextFile(const boost::filesystem::path &fname)
+void CSaveFile::deflateData(const void * data, unsigned size, int flush)
 {
+	deflateState->next_in = (Bytef *)data;
+	deflateState->avail_in = size;
+	do
+	{
+		deflateState->next_out = compressedBuffer.data();
+		deflateState->avail_out = compressedBuffer.size();
+		if(deflate(deflateState, flush) == Z_STREAM_ERROR)
+			THROW_FORMAT("Error: failed to compress data for %s!", fName);
+
+		sfile->write((char *)compressedBuffer.data(), compressedBuffer.size() - deflateState->avail_out);
+	}
+	while(deflateState->avail_out == 0);
+}
+
+void CSaveFile::openNextFile(const boost::filesystem::path &fname, bool compress, bool delta)
+{
+	clear();
 	fName = fname;
 	try
 	{
@@ -45,6 +78,22 @@ void CSaveFile::openNextFile(const boost::filesystem::path &fname)
 
 		sfile->write("VCMI",4); //write magic identifier
 		serializer & SERIALIZATION_VERSION; //write format version
+		ui8 flags = (compress ? SAVE_COMPRESSED : 0) | (delta ? SAVE_DELTA : 0);
+		serializer & flags;
+
+		if(compress)
+		{
+			deflateState = new z_stream();
+			deflateState->zalloc = Z_NULL;
+			deflateState->zfree = Z_NULL;
+			deflateState->opaque = Z_NULL;
+			if(deflateInit(deflateState, Z_DEFAULT_COMPRESSION) != Z_OK)
+			{
+				vstd::clear_pointer(deflateState);
+				THROW_FORMAT("Error: failed to initialize compression for %s!", fname);
+			}
+			compressedBuffer.resize(deflateBlockSize);
+		}
 	}
 	catch(...)
 	{
@@ -65,8 +114,19 @@ void CSaveFile::reportState(vstd::CLoggerBase * out)
 
 void CSaveFile::clear()
 {
-	fName.clear();
-	sfile = nullptr;
+	auto guard = vstd::makeScopeGuard([&]()
+	{
+		if(deflateState)
+		{
+			deflateEnd(deflateState);
+			vstd::clear_pointer(deflateState);
+		}
+		fName.clear();
+		sfile = nullptr;
+	});
+
+	if(deflateState && sfile)
+		deflateData(nullptr, 0, Z_FINISH);
 }
 
 void CSaveFile::putMagicBytes(const std::string &text)
@@ -13,6 +13,7 @@
 #include "../mapObjects/CArmedInstance.h"
 
 class FileStream;
+struct z_stream_s;
 
 class DLL_LINKAGE CSaverBase
 {
@@ -166,8 +167,21 @@ public:
 	void save(const T &data)
 	{
 		ui32 size = ARRAY_COUNT(data);
-		for(ui32 i=0; i < size; i++)
-			*this & data[i];
+		saveArray(data, size);
+	}
+
+	template < typename T, typename std::enable_if < is_bulk_serializeable<T>::value, int  >::type = 0 >
+	void saveArray(const T * data, ui32 length)
+	{
+		if(length)
+			this->write(data, sizeof(T) * length);
+	}
+
+	template < typename T, typename std::enable_if < !is_bulk_serializeable<T>::value, int  >::type = 0 >
+	void saveArray(const T * data, ui32 length)
+	{
+		for(ui32 i = 0; i < length; i++)
+			save(data[i]);
 	}
 
 	template < typename T, typename std::enable_if < std::is_pointer<T>::value, int  >::type = 0 >
@@ -255,14 +269,12 @@ public:
 	{
 		ui32 length = data.size();
 		*this & length;
-		for(ui32 i=0;i<length;i++)
-			save(data[i]);
+		saveArray(data.data(), length);
 	}
 	template <typename T, size_t N>
 	void save(const std::array<T, N> &data)
 	{
-		for(ui32 i=0; i < N; i++)
-			save(data[i]);
+		saveArray(data.data(), N);
 	}
 	template <typename T>
 	void save(const std::set<T> &data)
@@ -354,12 +366,12 @@ public:
 	boost::filesystem::path fName;
 	std::unique_ptr<FileStream> sfile;
 
-	CSaveFile(const boost::filesystem::path &fname); //throws!
+	CSaveFile(const boost::filesystem::path &fname, bool compress = false, bool delta = false); //throws!
 	~CSaveFile();
 	int write(const void * data, unsigned size) override;
 
-	void openNextFile(const boost::filesystem::path &fname); //throws!
-	void clear();
+	void openNextFile(const boost::filesystem::path &fname, bool compress = false, bool delta = false); //throws!
+	void clear(); //throws if compressed data can't be written
 	void reportState(vstd::CLoggerBase * out) override;
 
 	void putMagicBytes(const std::string &text);
@@ -370,4 +382,10 @@ public:
 		serializer & t;
 		return * this;
 	}
+
+private:
+	z_stream_s * deflateState; //not null if everything after header is deflated
+	std::vector<ui8> compressedBuffer;
+
+	void deflateData(const void * data, unsigned size, int flush);
 };
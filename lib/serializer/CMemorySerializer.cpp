@@ -9,9 +9,12 @@
  */
 #include "StdInc.h"
 #include "CMemorySerializer.h"
+#include "BinaryDelta.h"
 
 #include "../registerTypes/RegisterTypes.h"
 
+#include <zlib.h>
+
 int CMemorySerializer::read(void * data, unsigned size)
 {
 	if(buffer.size() < readPos + size)
@@ -38,3 +41,51 @@ CMemorySerializer::CMemorySerializer(): iser(this), oser(this)
 	iser.fileVersion = SERIALIZATION_VERSION;
 }
 
+int CMemorySaveFile::write(const void * data, unsigned size)
+{
+	auto oldSize = buffer.size();
+	buffer.resize(oldSize + size);
+	std::memcpy(buffer.data() + oldSize, data, size);
+	return size;
+}
+
+CMemorySaveFile::CMemorySaveFile(): serializer(this)
+{
+	registerTypes(serializer);
+}
+
+void CMemorySaveFile::putMagicBytes(const std::string & text)
+{
+	write(text.c_str(), text.length());
+}
+
+void CMemorySaveFile::writeTo(CSaveFile & file) const
+{
+	file.write(buffer.data(), buffer.size());
+}
+
+ui32 CMemorySaveFile::checksum() const
+{
+	return crc32(0, buffer.data(), buffer.size());
+}
+
+bool CMemorySaveFile::writeDeltaTo(const boost::filesystem::path & fname, bool compress, const CMemorySaveFile & base, const boost::filesystem::path & basePath) const
+{
+	std::vector<ui8> delta = BinaryDelta::encode(base.buffer, buffer);
+	if(delta.size() > buffer.size() / 2)
+		return false;
+
+	//base is usually kept next to its deltas or in their subdirectory, so the directory may be moved as whole
+	std::string baseName = basePath.string();
+	if(basePath.parent_path() == fname.parent_path())
+		baseName = basePath.filename().string();
+	else if(basePath.parent_path().parent_path() == fname.parent_path())
+		baseName = (basePath.parent_path().filename() / basePath.filename()).generic_string();
+	ui32 baseSize = base.buffer.size();
+	ui32 baseChecksum = base.checksum();
+
+	CSaveFile file(fname, compress, true);
+	file << baseName << baseSize << baseChecksum << delta;
+	return true;
+}
+
@@ -39,3 +39,24 @@ public:
 		return ret;
 	}
 };
+
+/// Collects savegame data in memory, so it can be written to the file later without accessing the game state.
+class DLL_LINKAGE CMemorySaveFile
+	: public IBinaryWriter
+{
+public:
+	std::vector<ui8> buffer;
+	BinarySerializer serializer;
+
+	int write(const void * data, unsigned size) override;
+
+	CMemorySaveFile();
+
+	void putMagicBytes(const std::string & text);
+	void writeTo(CSaveFile & file) const; //throws!
+	ui32 checksum() const; //CRC32 of the buffer
+
+	/// Writes only the difference against base, which must have been written to basePath already.
+	/// Returns false without creating the file if delta wouldn't be much smaller than full save.
+	bool writeDeltaTo(const boost::filesystem::path & fname, bool compress, const CMemorySaveFile & base, const boost::filesystem::path & basePath) const; //throws!
+};
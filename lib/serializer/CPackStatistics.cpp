@@ -0,0 +1,146 @@
+/*
+ * CPackStatistics.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CPackStatistics.h"
+
+#include "CTypeList.h"
+#include "../NetPacksBase.h"
+#include "../filesystem/FileStream.h"
+
+CPackStatistics::Entry::Entry()
+	: name(""), serialized(0), bytes(0), appliedGs(0), appliedCl(0),
+	serializeTime(0), applyGsTime(0), applyClTime(0)
+{
+}
+
+CPackStatistics::Timer::Timer()
+{
+	if(CPackStatistics::get().isEnabled())
+		start = std::chrono::steady_clock::now();
+}
+
+double CPackStatistics::Timer::elapsed() const
+{
+	if(start == std::chrono::steady_clock::time_point()) //started while statistics were disabled
+		return 0;
+
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+CPackStatistics::CPackStatistics()
+	: enabled(false)
+{
+}
+
+CPackStatistics & CPackStatistics::get()
+{
+	static CPackStatistics statistics;
+	return statistics;
+}
+
+void CPackStatistics::setEnabled(bool value)
+{
+	enabled = value;
+}
+
+bool CPackStatistics::isEnabled() const
+{
+	return enabled;
+}
+
+CPackStatistics::Entry & CPackStatistics::entry(const CPack * pack)
+{
+	auto & ret = entries[typeList.getTypeID(pack)];
+	ret.name = typeid(*pack).name();
+	return ret;
+}
+
+void CPackStatistics::addSerialized(const CPack * pack, size_t bytes, double time)
+{
+	if(!enabled)
+		return;
+
+	boost::unique_lock<boost::mutex> lock(mx);
+	auto & counters = entry(pack);
+	counters.serialized++;
+	counters.bytes += bytes;
+	counters.serializeTime += time;
+}
+
+void CPackStatistics::addAppliedGs(const CPack * pack, double time)
+{
+	if(!enabled)
+		return;
+
+	boost::unique_lock<boost::mutex> lock(mx);
+	auto & counters = entry(pack);
+	counters.appliedGs++;
+	counters.applyGsTime += time;
+}
+
+void CPackStatistics::addAppliedCl(const CPack * pack, double time)
+{
+	if(!enabled)
+		return;
+
+	boost::unique_lock<boost::mutex> lock(mx);
+	auto & counters = entry(pack);
+	counters.appliedCl++;
+	counters.applyClTime += time;
+}
+
+std::string CPackStatistics::toString() const
+{
+	std::vector<Entry> sorted;
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		for(auto & elem : entries)
+			sorted.push_back(elem.second);
+	}
+	boost::sort(sorted, [](const Entry & a, const Entry & b)
+	{
+		return a.serializeTime + a.applyGsTime + a.applyClTime > b.serializeTime + b.applyGsTime + b.applyClTime;
+	});
+
+	std::string ret = (boost::format("%-40s %8s %10s %10s %8s %10s %8s %10s\n") % "Pack" % "Sent" % "Bytes" % "Ser. ms" % "GS" % "GS ms" % "Client" % "Client ms").str();
+	for(auto & counters : sorted)
+	{
+		ret += (boost::format("%-40s %8d %10d %10.2f %8d %10.2f %8d %10.2f\n") % counters.name
+			% counters.serialized % counters.bytes % counters.serializeTime
+			% counters.appliedGs % counters.applyGsTime
+			% counters.appliedCl % counters.applyClTime).str();
+	}
+	return ret;
+}
+
+void CPackStatistics::writeCsv(const boost::filesystem::path & path) const
+{
+	FileStream file(path, std::ios::out | std::ios::trunc);
+	if(!file)
+		throw std::runtime_error("Cannot open " + path.string() + " for writing!");
+
+	file << "typeID,name,serialized,bytes,serializeMs,appliedGs,applyGsMs,appliedClient,applyClientMs\n";
+
+	boost::unique_lock<boost::mutex> lock(mx);
+	for(auto & elem : entries)
+	{
+		auto & counters = elem.second;
+		file << elem.first << ',' << counters.name << ','
+			<< counters.serialized << ',' << counters.bytes << ',' << counters.serializeTime << ','
+			<< counters.appliedGs << ',' << counters.applyGsTime << ','
+			<< counters.appliedCl << ',' << counters.applyClTime << '\n';
+	}
+}
+
+void CPackStatistics::clear()
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	entries.clear();
+}
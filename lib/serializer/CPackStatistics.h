@@ -0,0 +1,58 @@
+/*
+ * CPackStatistics.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+struct CPack;
+
+/// Counters of serialized packs and time spent on applying them, kept separately for every pack type
+/// Disabled by default, so sending and applying packs doesn't wait for shared lock
+class DLL_LINKAGE CPackStatistics : public boost::noncopyable
+{
+public:
+	struct Entry
+	{
+		const char * name; //mangled type name, as given by typeid
+		ui64 serialized, bytes;
+		ui64 appliedGs, appliedCl;
+		double serializeTime, applyGsTime, applyClTime; //in milliseconds
+
+		Entry();
+	};
+
+	/// Measures time of action, result is given in milliseconds; doesn't read clock while statistics are disabled
+	class Timer
+	{
+		std::chrono::steady_clock::time_point start;
+	public:
+		Timer();
+		double elapsed() const;
+	};
+
+	static CPackStatistics & get();
+
+	void setEnabled(bool value);
+	bool isEnabled() const;
+
+	void addSerialized(const CPack * pack, size_t bytes, double time);
+	void addAppliedGs(const CPack * pack, double time);
+	void addAppliedCl(const CPack * pack, double time);
+
+	std::string toString() const; //human readable table, sorted by total time
+	void writeCsv(const boost::filesystem::path & path) const; //throws!
+	void clear();
+
+private:
+	std::atomic<bool> enabled;
+	mutable boost::mutex mx;
+	std::map<ui16, Entry> entries; //pack type ID -> counters
+
+	CPackStatistics();
+	Entry & entry(const CPack * pack); //mx must be locked
+};
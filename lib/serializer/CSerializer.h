@@ -12,10 +12,17 @@
 #include "../ConstTransitivePtr.h"
 #include "../GameConstants.h"
 
-const ui32 SERIALIZATION_VERSION = 777;
+const ui32 SERIALIZATION_VERSION = 778;
 const ui32 MINIMAL_SERIALIZATION_VERSION = 753;
 const std::string SAVEGAME_MAGIC = "VCMISVG";
 
+/// Flags written after format version, describing how the rest of the file is stored
+enum ESaveFileFlags : ui8
+{
+	SAVE_COMPRESSED = 1, //everything after the flags is deflated
+	SAVE_DELTA = 2 //file contains only difference against another savegame, see CMemorySaveFile::writeDeltaTo
+};
+
 class CHero;
 class CGHeroInstance;
 class CGObjectInstance;
@@ -143,6 +150,13 @@ struct is_serializeable
 	static const bool value = sizeof(Yes) == sizeof(is_serializeable::test((typename std::remove_reference<typename std::remove_cv<T>::type>::type*)0));
 };
 
+/// Helper to detect types stored as their raw bytes, continuous blocks of them can be (de)serialized at once
+template<class T>
+struct is_bulk_serializeable
+{
+	static const bool value = std::is_fundamental<T>::value && !std::is_same<T, bool>::value;
+};
+
 template <typename T> //metafunction returning CGObjectInstance if T is its derivate or T elsewise
 struct VectorizedTypeFor
 {
@@ -109,6 +109,39 @@ std::vector<CTypeList::TypeInfoPtr> CTypeList::castSequence(const std::type_info
 	return castSequence(getTypeDescriptor(from), getTypeDescriptor(to));
 }
 
+const CTypeList::TCasterChain & CTypeList::casterChain(const std::type_info *from, const std::type_info *to) const
+{
+	static const TCasterChain noCasts;
+	if(!strcmp(from->name(), to->name()))
+		return noCasts;
+
+	auto fromDescr = getTypeDescriptor(from);
+	auto toDescr = getTypeDescriptor(to);
+	const ui32 key = (static_cast<ui32>(fromDescr->typeID) << 16) | toDescr->typeID;
+	{
+		TSharedLock lock(castCacheMx);
+		auto i = castCache.find(key);
+		if(i != castCache.end())
+			return i->second;
+	}
+
+	auto typesSequence = castSequence(fromDescr, toDescr);
+
+	TCasterChain chain;
+	for(int i = 0; i < static_cast<int>(typesSequence.size()) - 1; i++)
+	{
+		auto castingPair = std::make_pair(typesSequence[i], typesSequence[i + 1]);
+		auto caster = casters.find(castingPair);
+		if(caster == casters.end())
+			THROW_FORMAT("Cannot find caster for conversion %s -> %s which is needed to cast %s -> %s", castingPair.first->name % castingPair.second->name % from->name() % to->name());
+
+		chain.push_back(caster->second.get());
+	}
+
+	TUniqueLock lock(castCacheMx);
+	return castCache.emplace(key, std::move(chain)).first->second;
+}
+
 CTypeList::TypeInfoPtr CTypeList::getTypeDescriptor(const std::type_info *type, bool throws) const
 {
 	auto i = typeInfos.find(type);
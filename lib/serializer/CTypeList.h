@@ -74,8 +74,11 @@ class DLL_LINKAGE CTypeList: public boost::noncopyable
 	typedef boost::shared_mutex TMutex;
 	typedef boost::unique_lock<TMutex> TUniqueLock;
 	typedef boost::shared_lock<TMutex> TSharedLock;
+	typedef std::vector<const IPointerCaster *> TCasterChain;
 private:
 	mutable TMutex mx;
+	mutable TMutex castCacheMx; //guards castCache, which is filled while mx is only shared-locked
+	mutable std::unordered_map<ui32, TCasterChain> castCache; //(from ID << 16 | to ID) -> casters to be applied in order
 
 	std::map<const std::type_info *, TypeInfoPtr, TypeComparer> typeInfos;
 	std::map<std::pair<TypeInfoPtr, TypeInfoPtr>, std::unique_ptr<const IPointerCaster>> casters; //for each pair <Base, Der> we provide a caster (each registered relations creates a single entry here)
@@ -85,24 +88,18 @@ private:
 	std::vector<TypeInfoPtr> castSequence(TypeInfoPtr from, TypeInfoPtr to) const;
 	std::vector<TypeInfoPtr> castSequence(const std::type_info *from, const std::type_info *to) const;
 
+	/// Returns casters for every step of castSequence. Result is memoised until next type registration.
+	/// mx must be locked by caller.
+	const TCasterChain & casterChain(const std::type_info *from, const std::type_info *to) const;
+
 	template<boost::any(IPointerCaster::*CastingFunction)(const boost::any &) const>
 	boost::any castHelper(boost::any inputPtr, const std::type_info *fromArg, const std::type_info *toArg) const
 	{
 		TSharedLock lock(mx);
-		auto typesSequence = castSequence(fromArg, toArg);
 
 		boost::any ptr = inputPtr;
-		for(int i = 0; i < static_cast<int>(typesSequence.size()) - 1; i++)
-		{
-			auto &from = typesSequence[i];
-			auto &to = typesSequence[i + 1];
-			auto castingPair = std::make_pair(from, to);
-			if(!casters.count(castingPair))
-				THROW_FORMAT("Cannot find caster for conversion %s -> %s which is needed to cast %s -> %s", from->name % to->name % fromArg->name() % toArg->name());
-
-			auto &caster = casters.at(castingPair);
-			ptr = (*caster.*CastingFunction)(ptr); //Why does unique_ptr not have operator->* ..?
-		}
+		for(auto caster : casterChain(fromArg, toArg))
+			ptr = (caster->*CastingFunction)(ptr);
 
 		return ptr;
 	}
@@ -137,6 +134,7 @@ public:
 		dti->parents.push_back(bti);
 		casters[std::make_pair(bti, dti)] = make_unique<const PointerCaster<Base, Derived>>();
 		casters[std::make_pair(dti, bti)] = make_unique<const PointerCaster<Derived, Base>>();
+		castCache.clear(); //casters were replaced and new paths may exist
 	}
 
 	ui16 getTypeID(const std::type_info *type, bool throws = false) const;
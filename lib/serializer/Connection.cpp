@@ -9,6 +9,7 @@
  */
 #include "StdInc.h"
 #include "Connection.h"
+#include "CPackStatistics.h"
 
 #include "../registerTypes/RegisterTypes.h"
 #include "../mapping/CMap.h"
@@ -48,6 +49,7 @@ void CConnection::init()
 	std::string pom;
 	//we got connection
 	oser & std::string("Aiya!\n") & name & myEndianess; //identify ourselves
+	flush();
 	iser & pom & pom & contactEndianess;
 	logNetwork->info("Established connection with %s", pom);
 	wmx = new boost::mutex();
@@ -61,7 +63,7 @@ void CConnection::init()
 }
 
 CConnection::CConnection(std::string host, ui16 port, std::string Name)
-:iser(this), oser(this), io_service(new asio::io_service), name(Name)
+:inputPosition(0), batchDepth(0), iser(this), oser(this), io_service(new asio::io_service), name(Name)
 {
 	int i;
 	boost::system::error_code error = asio::error::host_not_found;
@@ -116,12 +118,12 @@ connerror1:
 	throw std::runtime_error("Can't establish connection :(");
 }
 CConnection::CConnection(TSocket * Socket, std::string Name )
-	:iser(this), oser(this), socket(Socket),io_service(&Socket->get_io_service()), name(Name)//, send(this), rec(this)
+	:inputPosition(0), batchDepth(0), iser(this), oser(this), socket(Socket),io_service(&Socket->get_io_service()), name(Name)//, send(this), rec(this)
 {
 	init();
 }
 CConnection::CConnection(TAcceptor * acceptor, boost::asio::io_service *Io_service, std::string Name)
-: iser(this), oser(this), name(Name)//, send(this), rec(this)
+: inputPosition(0), batchDepth(0), iser(this), oser(this), name(Name)//, send(this), rec(this)
 {
 	boost::system::error_code error = asio::error::host_not_found;
 	socket = new tcp::socket(*io_service);
@@ -135,26 +137,60 @@ CConnection::CConnection(TAcceptor * acceptor, boost::asio::io_service *Io_servi
 	init();
 }
 int CConnection::write(const void * data, unsigned size)
+{
+	auto bytes = static_cast<const ui8 *>(data);
+	outputBuffer.insert(outputBuffer.end(), bytes, bytes + size);
+	return size;
+}
+int CConnection::read(void * data, unsigned size)
+{
+	auto bytes = static_cast<ui8 *>(data);
+	unsigned remaining = size;
+	while(remaining)
+	{
+		if(inputPosition == inputBuffer.size())
+			readFrame();
+
+		unsigned chunk = std::min<size_t>(remaining, inputBuffer.size() - inputPosition);
+		std::copy_n(inputBuffer.begin() + inputPosition, chunk, bytes);
+		inputPosition += chunk;
+		bytes += chunk;
+		remaining -= chunk;
+	}
+	return size;
+}
+void CConnection::readFrame()
 {
 	try
 	{
-		int ret;
-		ret = asio::write(*socket,asio::const_buffers_1(asio::const_buffer(data,size)));
-		return ret;
+		//frame length is always little endian, it's read before endianess of other side is known
+		std::array<ui8, 4> header;
+		asio::read(*socket,asio::mutable_buffers_1(asio::mutable_buffer(header.data(),header.size())));
+		ui32 length = header[0] | (header[1] << 8) | (header[2] << 16) | (ui32(header[3]) << 24);
+		if(length > MAX_FRAME_SIZE)
+			THROW_FORMAT("Error: frame of %d bytes received, connection is broken!", length);
+
+		inputBuffer.resize(length);
+		inputPosition = 0;
+		asio::read(*socket,asio::mutable_buffers_1(asio::mutable_buffer(inputBuffer.data(),length)));
 	}
 	catch(...)
 	{
 		//connection has been lost
 		connected = false;
+		inputBuffer.clear();
+		inputPosition = 0;
 		throw;
 	}
 }
-int CConnection::read(void * data, unsigned size)
+void CConnection::writeFrame(const std::vector<ui8> & frame)
 {
+	const ui32 length = frame.size();
+	std::array<ui8, 4> header = {ui8(length), ui8(length >> 8), ui8(length >> 16), ui8(length >> 24)};
+	std::array<asio::const_buffer, 2> buffers = {asio::const_buffer(header.data(),header.size()), asio::const_buffer(frame.data(),length)};
 	try
 	{
-		int ret = asio::read(*socket,asio::mutable_buffers_1(asio::mutable_buffer(data,size)));
-		return ret;
+		asio::write(*socket,buffers);
 	}
 	catch(...)
 	{
@@ -163,6 +199,87 @@ int CConnection::read(void * data, unsigned size)
 		throw;
 	}
 }
+void CConnection::flush()
+{
+	if(outputBuffer.empty())
+		return;
+
+	if(isBatching())
+	{
+		batchBuffer.insert(batchBuffer.end(), outputBuffer.begin(), outputBuffer.end());
+		outputBuffer.clear();
+		return;
+	}
+
+	try
+	{
+		flushBatch();
+		writeFrame(outputBuffer);
+	}
+	catch(...)
+	{
+		outputBuffer.clear();
+		throw;
+	}
+	outputBuffer.clear();
+}
+void CConnection::sendFrame(const std::vector<ui8> & frame)
+{
+	assert(outputBuffer.empty());
+	if(frame.empty())
+		return;
+
+	if(isBatching())
+		batchBuffer.insert(batchBuffer.end(), frame.begin(), frame.end());
+	else
+	{
+		flushBatch();
+		writeFrame(frame);
+	}
+}
+bool CConnection::isBatching() const
+{
+	return batchDepth && batchOwner == boost::this_thread::get_id();
+}
+void CConnection::flushBatch()
+{
+	if(batchBuffer.empty())
+		return;
+
+	//reader doesn't care about frame boundaries, so packs written one after another can share a frame
+	std::vector<ui8> frame;
+	std::swap(frame, batchBuffer);
+	writeFrame(frame);
+}
+bool CConnection::beginBatch()
+{
+	if(batchDepth && !isBatching())
+		return false;
+
+	batchOwner = boost::this_thread::get_id();
+	batchDepth++;
+	return true;
+}
+void CConnection::endBatch()
+{
+	assert(isBatching());
+	if(--batchDepth)
+		return;
+
+	batchOwner = boost::thread::id();
+	flushBatch();
+}
+bool CConnection::hasBufferedInput() const
+{
+	return inputPosition < inputBuffer.size();
+}
+bool CConnection::isFrameCompatible(const CConnection & other) const
+{
+	//with smart pointers serialized data depends on what was sent through connection before
+	return !oser.smartPointerSerialization && !other.oser.smartPointerSerialization
+		&& smartVectorMembersSerialization == other.smartVectorMembersSerialization
+		&& sendStackInstanceByIds == other.sendStackInstanceByIds;
+}
 CConnection::~CConnection(void)
 {
 	if(handler)
@@ -228,7 +345,28 @@ void CConnection::sendPackToServer(const CPack &pack, PlayerColor player, ui32 r
 {
 	boost::unique_lock<boost::mutex> lock(*wmx);
 	logNetwork->trace("Sending to server a pack of type %s", typeid(pack).name());
+	CPackStatistics::Timer timer;
 	oser & player & requestID & &pack; //packs has to be sent as polymorphic pointers!
+	CPackStatistics::get().addSerialized(&pack, outputBuffer.size(), timer.elapsed());
+	flush();
+}
+
+void CConnection::sendPack(const CPack * pack)
+{
+	CPackStatistics::Timer timer;
+	oser & pack;
+	CPackStatistics::get().addSerialized(pack, outputBuffer.size(), timer.elapsed());
+	flush();
+}
+
+std::vector<ui8> CConnection::serializePack(const CPack * pack)
+{
+	CPackStatistics::Timer timer;
+	oser & pack;
+	std::vector<ui8> frame;
+	std::swap(frame, outputBuffer);
+	CPackStatistics::get().addSerialized(pack, frame.size(), timer.elapsed());
+	return frame;
 }
 
 void CConnection::disableStackSendingByID()
@@ -40,16 +40,29 @@ typedef boost::asio::basic_socket_acceptor<boost::asio::ip::tcp, boost::asio::so
 
 /// Main class for network communication
 /// Allows establishing connection and bidirectional read-write
+/// Data is sent in length-prefixed frames: everything written by single operator<< is buffered and sent at once
 class DLL_LINKAGE CConnection
 	: public IBinaryReader, public IBinaryWriter
 {
 	CConnection(void);
 
+	static const ui32 MAX_FRAME_SIZE = 256 * 1024 * 1024; //longer frame means stream is corrupted, it's not allocated
+
+	std::vector<ui8> inputBuffer, outputBuffer;
+	size_t inputPosition;
+	std::vector<ui8> batchBuffer; //frames collected while batch is open, sent as single frame
+	int batchDepth;
+	boost::thread::id batchOwner; //only frames sent by thread that opened batch are held back
+
 	void init();
 	void reportState(vstd::CLoggerBase * out) override;
 
 	int write(const void * data, unsigned size) override;
 	int read(void * data, unsigned size) override;
+	void readFrame();
+	void writeFrame(const std::vector<ui8> & frame);
+	bool isBatching() const; //true if batch is open by calling thread
+	void flushBatch(); //sends frames collected so far, so data from other thread doesn't overtake them
 public:
 	BinaryDeserializer iser;
 	BinarySerializer oser;
@@ -73,12 +86,19 @@ public:
 	void close();
 	bool isOpen() const;
 	bool isHost() const;
+	void flush(); //sends buffered data as one frame
+	void sendFrame(const std::vector<ui8> & frame); //sends data serialized by compatible connection
+	bool beginBatch(); //following frames of calling thread are held back and sent as one frame by matching endBatch, may be nested; false if other thread has batch open
+	void endBatch();
+	bool hasBufferedInput() const; //true if part of last frame is not read yet, so next pack can be read without waiting for socket
+	bool isFrameCompatible(const CConnection & other) const; //true if data serialized by other connection can be sent through this one
 	template<class T>
 	CConnection &operator&(const T&);
 	virtual ~CConnection(void);
 
 	CPack *retreivePack(); //gets from server next pack (allocates it with new)
 	void sendPackToServer(const CPack &pack, PlayerColor player, ui32 requestID);
+	void sendPack(const CPack * pack); //sends pack to this connection only, wmx must be locked
 
 	void disableStackSendingByID();
 	void enableStackSendingByID();
@@ -99,10 +119,14 @@ public:
 		return * this;
 	}
 
+	/// Serializes pack without sending it, result can be sent to all compatible connections
+	std::vector<ui8> serializePack(const CPack * pack);
+
 	template<class T>
 	CConnection & operator<<(const T &t)
 	{
 		oser & t;
+		flush();
 		return * this;
 	}
 };
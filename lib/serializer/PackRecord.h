@@ -0,0 +1,35 @@
+/*
+ * PackRecord.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "../NetPacksBase.h"
+
+/// Single entry of the record made by server with --record option, replayed with --replay.
+/// Recorded packs are replayed without connections, so player owning the connection is stored next to the pack.
+struct RecordedEvent
+{
+	enum EType : ui8 {PACK, NEW_TURN, PLAYER_TURN, END};
+
+	EType type;
+	PlayerColor player; //player pack was sent as, or player whose turn begins
+	PlayerColor actingPlayer; //player at the connection pack came from, only for packs
+	CPack * pack; //not owned
+
+	RecordedEvent(EType Type = END, PlayerColor Player = PlayerColor::NEUTRAL)
+		: type(Type), player(Player), actingPlayer(PlayerColor::NEUTRAL), pack(nullptr)
+	{}
+
+	template <typename Handler> void serialize(Handler & h, const int version)
+	{
+		h & type & player;
+		if(type == PACK)
+			h & actingPlayer & pack;
+	}
+};
@@ -225,8 +225,7 @@ bool CureMechanics::dispellSelector(const Bonus * b)
 
 ESpellCastProblem::ESpellCastProblem CureMechanics::isImmuneByStack(const ISpellCaster * caster, const CStack * obj) const
 {
-	//Selector method name is ok as cashing string. --AVS
-	if(!obj->canBeHealed() && !canDispell(obj, dispellSelector, "CureMechanics::dispellSelector"))
+	if(!obj->canBeHealed() && !canDispell(obj, dispellSelector, BonusCacheKey::make(BonusCacheKey::CURE_DISPELLABLE)))
 		return ESpellCastProblem::STACK_IMMUNE_TO_SPELL;
 
 	return DefaultSpellMechanics::isImmuneByStack(caster, obj);
@@ -253,13 +252,12 @@ ESpellCastProblem::ESpellCastProblem DispellMechanics::isImmuneByStack(const ISp
 	//DISPELL ignores all immunities, except specific absolute immunity
 	{
 		//SPELL_IMMUNITY absolute case
-		std::stringstream cachingStr;
-		cachingStr << "type_" << Bonus::SPELL_IMMUNITY << "subtype_" << owner->id.toEnum() << "addInfo_1";
-		if(obj->hasBonus(Selector::typeSubtypeInfo(Bonus::SPELL_IMMUNITY, owner->id.toEnum(), 1), cachingStr.str()))
+		TBonusCacheKey cachingKey = BonusCacheKey::make(BonusCacheKey::TYPE_SUBTYPE_INFO, Bonus::SPELL_IMMUNITY, 1, owner->id.toEnum());
+		if(obj->hasBonus(Selector::typeSubtypeInfo(Bonus::SPELL_IMMUNITY, owner->id.toEnum(), 1), cachingKey))
 			return ESpellCastProblem::STACK_IMMUNE_TO_SPELL;
 	}
 
-	if(canDispell(obj, Selector::all, "DefaultSpellMechanics::dispellSelector"))
+	if(canDispell(obj, Selector::all, BonusCacheKey::make(BonusCacheKey::DISPELLABLE)))
 		return ESpellCastProblem::OK;
 	else
 		return ESpellCastProblem::WRONG_SPELL_TARGET;
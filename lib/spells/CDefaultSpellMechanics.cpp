@@ -786,9 +786,9 @@ void DefaultSpellMechanics::doDispell(BattleInfo * battle, const BattleSpellCast
 	}
 }
 
-bool DefaultSpellMechanics::canDispell(const IBonusBearer * obj, const CSelector & selector, const std::string & cachingStr) const
+bool DefaultSpellMechanics::canDispell(const IBonusBearer * obj, const CSelector & selector, TBonusCacheKey cachingKey) const
 {
-	return obj->hasBonus(selector.And(dispellSelector), Selector::all, cachingStr);
+	return obj->hasBonus(selector.And(dispellSelector), Selector::all, cachingKey);
 }
 
 void DefaultSpellMechanics::handleMagicMirror(const SpellCastEnvironment * env, SpellCastContext & ctx, std::vector <const CStack*> & reflected) const
@@ -52,9 +52,8 @@ ESpellCastProblem::ESpellCastProblem AcidBreathDamageMechanics::isImmuneByStack(
 	//ignore all immunities, except specific absolute immunity
 	{
 		//SPELL_IMMUNITY absolute case
-		std::stringstream cachingStr;
-		cachingStr << "type_" << Bonus::SPELL_IMMUNITY << "subtype_" << owner->id.toEnum() << "addInfo_1";
-		if(obj->hasBonus(Selector::typeSubtypeInfo(Bonus::SPELL_IMMUNITY, owner->id.toEnum(), 1), cachingStr.str()))
+		TBonusCacheKey cachingKey = BonusCacheKey::make(BonusCacheKey::TYPE_SUBTYPE_INFO, Bonus::SPELL_IMMUNITY, 1, owner->id.toEnum());
+		if(obj->hasBonus(Selector::typeSubtypeInfo(Bonus::SPELL_IMMUNITY, owner->id.toEnum(), 1), cachingKey))
 			return ESpellCastProblem::STACK_IMMUNE_TO_SPELL;
 	}
 	return ESpellCastProblem::OK;
@@ -104,7 +103,7 @@ void DispellHelpfulMechanics::applyBattle(BattleInfo * battle, const BattleSpell
 
 ESpellCastProblem::ESpellCastProblem DispellHelpfulMechanics::isImmuneByStack(const ISpellCaster * caster,  const CStack * obj) const
 {
-	if(!canDispell(obj, positiveSpellEffects, "DispellHelpfulMechanics::positiveSpellEffects"))
+	if(!canDispell(obj, positiveSpellEffects, BonusCacheKey::make(BonusCacheKey::HELPFUL_DISPELLABLE)))
 		return ESpellCastProblem::NO_SPELLS_TO_DISPEL;
 
 	//use default algorithm only if there is no mechanics-related problem
@@ -34,6 +34,7 @@
 #include "../lib/VCMIDirs.h"
 #include "../lib/ScopeGuard.h"
 #include "../lib/CSoundBase.h"
+#include "../lib/CConfigHandler.h"
 #include "CGameHandler.h"
 #include "CVCMIServer.h"
 #include "../lib/CCreatureSet.h"
@@ -42,6 +43,9 @@
 #include "../lib/registerTypes/RegisterTypes.h"
 #include "../lib/serializer/CTypeList.h"
 #include "../lib/serializer/Connection.h"
+#include "../lib/serializer/CMemorySerializer.h"
+#include "../lib/serializer/CPackStatistics.h"
+#include "../lib/serializer/PackRecord.h"
 
 #ifndef _MSC_VER
 #include <boost/thread/xtime.hpp>
@@ -77,6 +81,36 @@ private:
 
 CondSh<bool> battleMadeAction(false);
 CondSh<BattleResult *> battleResult(nullptr);
+
+/// What battle thread is doing, guarded by battleMadeAction.mx
+/// Replay uses it to apply recorded battle actions only when battle thread is ready for them
+enum EBattleThreadState {BATTLE_THREAD_NOT_RUNNING, BATTLE_THREAD_BUSY, BATTLE_THREAD_IN_TACTICS, BATTLE_THREAD_AWAITS_ACTION};
+static EBattleThreadState battleThreadState = BATTLE_THREAD_NOT_RUNNING;
+
+static void setBattleThreadState(EBattleThreadState state)
+{
+	{
+		boost::unique_lock<boost::mutex> lock(battleMadeAction.mx);
+		battleThreadState = state;
+	}
+	battleMadeAction.cond.notify_all();
+}
+
+/// Checks if battle thread waits for next action, battleMadeAction.mx must be locked
+static bool isBattleThreadReady(const CGameState * gs)
+{
+	switch(battleThreadState)
+	{
+	case BATTLE_THREAD_NOT_RUNNING:
+		return true;
+	case BATTLE_THREAD_IN_TACTICS: //thread may have not noticed that tactic phase was ended
+		return gs->curB && gs->curB->tacticDistance && !battleResult.get();
+	case BATTLE_THREAD_AWAITS_ACTION:
+		return !battleMadeAction.data;
+	default:
+		return false;
+	}
+}
 template <typename T> class CApplyOnGH;
 
 class CBaseForGHApply
@@ -1021,6 +1055,7 @@ void CGameHandler::handleConnection(std::set<PlayerColor> players, CConnection &
 
 	auto handleDisconnection = [&](const std::exception & e)
 	{
+		auto deterministicLock = lockForDeterministicApply();
 		boost::unique_lock<boost::mutex> lock(*c.wmx);
 		assert(!c.connected); //make sure that connection has been marked as broken
 		logGlobal->error(e.what());
@@ -1066,6 +1101,17 @@ void CGameHandler::handleConnection(std::set<PlayerColor> players, CConnection &
 				}
 			}
 
+			//with deterministic random packs are applied one by one, in the same order as they are recorded
+			auto deterministicLock = lockForDeterministicApply();
+			//leaving game makes no sense without connection
+			if(pack && !dynamic_cast<LeaveGame *>(pack) && !dynamic_cast<CloseServer *>(pack))
+			{
+				RecordedEvent event(RecordedEvent::PACK, player);
+				event.actingPlayer = getPlayerAt(&c);
+				event.pack = pack;
+				recordEvent(event);
+			}
+
 			//prepare struct informing that action was applied
 			auto sendPackageResponse = [&](bool succesfullyApplied)
 			{
@@ -1080,7 +1126,7 @@ void CGameHandler::handleConnection(std::set<PlayerColor> players, CConnection &
 				applied.packType = packType;
 				applied.requestID = requestID;
 				boost::unique_lock<boost::mutex> lock(*c.wmx);
-				c << &applied;
+				c.sendPack(&applied);
 			};
 			CBaseForGHApply *apply = applier->getApplier(packType); //and appropriate applier object
 			if(isBlockedByQueries(pack, player))
@@ -1089,6 +1135,13 @@ void CGameHandler::handleConnection(std::set<PlayerColor> players, CConnection &
 			}
 			else if (apply)
 			{
+				//packs produced by the request are sent to clients as single frame, together with the response
+				const auto batched = beginPackBatch();
+				auto batchGuard = vstd::makeScopeGuard([&]()
+				{
+					endPackBatch(batched);
+				});
+
 				const bool result = apply->applyOnGH(this, &c, pack, player);
 				if (result)
 					logGlobal->trace("Message %s successfully applied!", typeid(*pack).name());
@@ -1398,12 +1451,16 @@ CGameHandler::CGameHandler(void)
 	applier = new CApplier<CBaseForGHApply>();
 	registerTypesServerPacks(*applier);
 	visitObjectAfterVictory = false;
+	deterministicRandom = false;
 
 	spellEnv = new ServerSpellCastEnvironment(this);
 }
 
 CGameHandler::~CGameHandler(void)
 {
+	waitForSave();
+	if(packRecord)
+		recordEvent(RecordedEvent(RecordedEvent::END));
 	delete spellEnv;
 	delete applier;
 	applier = nullptr;
@@ -1837,6 +1894,10 @@ void CGameHandler::run(bool resume)
 		cc->disableSmartPointerSerialization();
 	}
 
+	//recorded state must be saved before connection threads start changing it
+	if(cmdLineOptions.count("record"))
+		startRecording(cmdLineOptions["record"].as<std::string>());
+
 	for (auto & elem : conns)
 	{
 		std::set<PlayerColor> pom;
@@ -1851,7 +1912,12 @@ void CGameHandler::run(bool resume)
 
 	while(!serverShuttingDown)
 	{
-		if (!resume) newTurn();
+		if (!resume)
+		{
+			auto deterministicLock = lockForDeterministicApply();
+			recordEvent(RecordedEvent(RecordedEvent::NEW_TURN));
+			newTurn();
+		}
 
 		std::list<PlayerColor>::iterator it;
 		if (resume)
@@ -1868,26 +1934,16 @@ void CGameHandler::run(bool resume)
 		{
 			auto playerColor = *it;
 
-			PlayerState * playerState = &gs->players[playerColor]; //can't copy CBonusSystemNode by value
-			if (playerState->status == EPlayerStatus::INGAME)
+			if (gs->players[playerColor].status == EPlayerStatus::INGAME)
 			{
-				//if player runs out of time, he shouldn't get the turn (especially AI)
-				checkVictoryLossConditionsForAll();
-
-				if (gs->players[playerColor].status != EPlayerStatus::INGAME)
-				{ //player lost at the beginning of his turn
-					continue;
+				bool turnGiven;
+				{
+					auto deterministicLock = lockForDeterministicApply();
+					recordEvent(RecordedEvent(RecordedEvent::PLAYER_TURN, playerColor));
+					turnGiven = giveTurn(playerColor);
 				}
-				else //give normal turn
+				if (turnGiven)
 				{
-					states.setFlag(playerColor, &PlayerStatus::makingTurn, true);
-
-					YourTurn yt;
-					yt.player = playerColor;
-					//Change local daysWithoutCastle counter for local interface message //TODO: needed?
-					yt.daysWithoutCastle = playerState->daysWithoutCastle;
-					applyAndSend(&yt);
-
 					//wait till turn is done
 					boost::unique_lock<boost::mutex> lock(states.mx);
 					while(states.players.at(playerColor).makingTurn && !serverShuttingDown)
@@ -1910,6 +1966,16 @@ void CGameHandler::run(bool resume)
 	}
 	while(conns.size() && (*conns.begin())->isOpen())
 		boost::this_thread::sleep(boost::posix_time::milliseconds(5)); //give time client to close socket
+
+	try
+	{
+		if(CPackStatistics::get().isEnabled())
+			CPackStatistics::get().writeCsv(VCMIDirs::get().userCachePath() / "VCMI_Server_packs.csv");
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Failed to write pack statistics: %s", e.what());
+	}
 }
 
 std::list<PlayerColor> CGameHandler::generatePlayerTurnOrder() const
@@ -2415,6 +2481,7 @@ void CGameHandler::startBattlePrimary(const CArmedInstance *army1, const CArmedI
 	auto battleQuery = std::make_shared<CBattleQuery>(this, gs->curB);
 	queries.addQuery(battleQuery);
 
+	setBattleThreadState(BATTLE_THREAD_BUSY);
 	boost::thread(&CGameHandler::runBattle, this);
 }
 
@@ -2445,7 +2512,7 @@ void CGameHandler::sendMessageTo(CConnection &c, const std::string &message)
 	SystemMessage sm;
 	sm.text = message;
 	boost::unique_lock<boost::mutex> lock(*c.wmx);
-	c << &sm;
+	c.sendPack(&sm);
 }
 
 void CGameHandler::giveHeroBonus(GiveBonus * bonus)
@@ -2595,13 +2662,54 @@ void CGameHandler::heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2)
 void CGameHandler::sendToAllClients(CPackForClient * info)
 {
 	logNetwork->trace("Sending to all clients a package of type %s", typeid(*info).name());
+
+	//pack is serialized once and same data is sent to every connection with same serialization settings
+	std::vector<ui8> frame;
+	const CConnection * frameSource = nullptr;
 	for (auto & elem : conns)
 	{
 		if(!elem->isOpen())
 			continue;
 
 		boost::unique_lock<boost::mutex> lock(*(elem)->wmx);
-		*elem << info;
+		if(!frameSource || !elem->isFrameCompatible(*frameSource))
+		{
+			frame = elem->serializePack(info);
+			frameSource = elem;
+		}
+		elem->sendFrame(frame);
+	}
+}
+
+std::set<CConnection *> CGameHandler::beginPackBatch()
+{
+	std::set<CConnection *> batched;
+	for(auto & elem : conns)
+	{
+		if(!elem->isOpen())
+			continue;
+
+		boost::unique_lock<boost::mutex> lock(*(elem)->wmx);
+		if(elem->beginBatch())
+			batched.insert(elem);
+	}
+	return batched;
+}
+
+void CGameHandler::endPackBatch(const std::set<CConnection *> & batched)
+{
+	for(auto & elem : batched)
+	{
+		boost::unique_lock<boost::mutex> lock(*(elem)->wmx);
+		try
+		{
+			elem->endBatch();
+		}
+		catch(std::exception & e)
+		{
+			//connection is marked as broken, its handler will notice that
+			logNetwork->error("Failed to send packs to %s: %s", elem->toString(), e.what());
+		}
 	}
 }
 
@@ -2635,6 +2743,48 @@ void CGameHandler::sendAndApply(NewStructures * info)
 	checkVictoryLossConditionsForPlayer(getTown(info->tid)->tempOwner);
 }
 
+/// Delta bases are not savegames, so they are kept in subdirectory with extension that isn't listed as save
+static const std::string DELTA_BASE_DIR = "DeltaBases";
+static const std::string DELTA_BASE_EXTENSION = ".vdbase";
+
+/// Removes delta bases that no save in saveDir is stored against
+static void removeUnusedDeltaBases(const boost::filesystem::path & saveDir)
+{
+	namespace fs = boost::filesystem;
+	const fs::path baseDir = saveDir / DELTA_BASE_DIR;
+	if(!fs::is_directory(baseDir))
+		return;
+
+	std::set<fs::path> used;
+	for(fs::directory_iterator it(saveDir); it != fs::directory_iterator(); ++it)
+	{
+		if(!fs::is_regular_file(it->path()) || !boost::iequals(it->path().extension().string(), ".vsgm1"))
+			continue;
+		try
+		{
+			CLoadFile save(it->path(), MINIMAL_SERIALIZATION_VERSION, false);
+			if(!save.deltaBase.empty())
+				used.insert(save.deltaBase.filename());
+		}
+		catch(std::exception & e)
+		{
+			logGlobal->warn("Cannot check which delta base %s uses: %s", it->path().string(), e.what());
+		}
+	}
+
+	for(fs::directory_iterator it(baseDir); it != fs::directory_iterator(); ++it)
+	{
+		if(it->path().extension() != DELTA_BASE_EXTENSION || vstd::contains(used, it->path().filename()))
+			continue;
+		boost::system::error_code error;
+		fs::remove(it->path(), error);
+		if(error)
+			logGlobal->warn("Failed to remove unused delta base %s: %s", it->path().string(), error.message());
+		else
+			logGlobal->info("Removed unused delta base %s", it->path().string());
+	}
+}
+
 void CGameHandler::save(const std::string & filename)
 {
 	logGlobal->info("Saving to %s", filename);
@@ -2648,19 +2798,264 @@ void CGameHandler::save(const std::string & filename)
 		sendToAllClients(&sg);
 	}
 
+	//previous save must be written before its file may be replaced
+	waitForSave();
+
+	auto snapshot = std::make_shared<CMemorySaveFile>();
 	try
 	{
-		{
-			CSaveFile save(*CResourceHandler::get("local")->getResourceName(ResourceID(stem.to_string(), EResType::SERVER_SAVEGAME)));
-			saveCommonState(save);
-			logGlobal->info("Saving server state");
-			save << *this;
-		}
-		logGlobal->info("Game has been successfully saved!");
+		saveCommonState(*snapshot);
+		logGlobal->info("Saving server state");
+		snapshot->serializer & *this;
 	}
 	catch(std::exception &e)
 	{
 		logGlobal->error("Failed to save game: %s", e.what());
+		return;
+	}
+
+	//game state is not accessed anymore, compression and disk access happen in background
+	const auto path = *CResourceHandler::get("local")->getResourceName(ResourceID(stem.to_string(), EResType::SERVER_SAVEGAME));
+	const bool compress = settings["general"]["compressSaves"].Bool();
+	const bool delta = settings["general"]["deltaSaves"].Bool();
+	saveThread = make_unique<boost::thread>([this, snapshot, path, compress, delta]()
+	{
+		setThreadName("CGameHandler::saveThread");
+		try
+		{
+			bool written = false;
+			if(delta)
+			{
+				const auto baseDir = path.parent_path() / DELTA_BASE_DIR;
+				//saves in other directory don't keep their base alive, see removeUnusedDeltaBases
+				if(deltaBase && deltaBasePath.parent_path() == baseDir && boost::filesystem::exists(deltaBasePath))
+					written = snapshot->writeDeltaTo(path, compress, *deltaBase, deltaBasePath);
+				if(!written)
+				{
+					//base has its own file, so overwriting any save can't break deltas made against it
+					boost::filesystem::create_directories(baseDir);
+					auto basePath = baseDir / boost::str(boost::format("%08x%s") % snapshot->checksum() % DELTA_BASE_EXTENSION);
+					{
+						CSaveFile base(basePath, compress);
+						snapshot->writeTo(base);
+					}
+					logGlobal->info("Saved new delta base %s", basePath.string());
+					deltaBase = snapshot;
+					deltaBasePath = basePath;
+					written = snapshot->writeDeltaTo(path, compress, *deltaBase, deltaBasePath);
+				}
+			}
+			if(!written)
+			{
+				CSaveFile save(path, compress);
+				snapshot->writeTo(save);
+			}
+			logGlobal->info("Game has been successfully saved!");
+			removeUnusedDeltaBases(path.parent_path());
+		}
+		catch(std::exception &e)
+		{
+			logGlobal->error("Failed to save game: %s", e.what());
+		}
+	});
+}
+
+/// Packs are recorded the way they are sent over network: game objects are referenced by their IDs
+static void prepareForRecordedPacks(CSerializer & serializer, CGameState * gs)
+{
+	serializer.addStdVecItems(gs);
+	serializer.smartVectorMembersSerialization = true;
+	serializer.sendStackInstanceByIds = true;
+}
+
+void CGameHandler::startRecording(const std::string & fname)
+{
+	logGlobal->info("Recording received packs to %s", fname);
+	boost::unique_lock<boost::mutex> lock(packRecordMx);
+	try
+	{
+		deterministicRandom = true;
+		packRecord = make_unique<CSaveFile>(fname, settings["general"]["compressSaves"].Bool());
+		saveCommonState(*packRecord);
+		*packRecord << *this;
+
+		prepareForRecordedPacks(*packRecord, gs);
+		packRecord->serializer.smartPointerSerialization = false; //packs are deleted after being applied, their addresses get reused
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Failed to start recording: %s", e.what());
+		packRecord.reset();
+	}
+}
+
+void CGameHandler::recordEvent(const RecordedEvent & event)
+{
+	boost::unique_lock<boost::mutex> lock(packRecordMx);
+	if(!packRecord)
+		return;
+
+	try
+	{
+		*packRecord << event;
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Failed to record pack, recording is stopped: %s", e.what());
+		packRecord.reset();
+	}
+}
+
+void CGameHandler::waitForBattleThread()
+{
+	boost::unique_lock<boost::mutex> lock(battleMadeAction.mx);
+	while(!isBattleThreadReady(gs))
+		battleMadeAction.cond.wait(lock);
+}
+
+boost::unique_lock<boost::mutex> CGameHandler::lockForDeterministicApply()
+{
+	boost::unique_lock<boost::mutex> lock(deterministicMx, boost::defer_lock);
+	if(!deterministicRandom)
+		return lock;
+
+	for(;;)
+	{
+		waitForBattleThread();
+		lock.lock();
+		{
+			boost::unique_lock<boost::mutex> battleLock(battleMadeAction.mx);
+			if(isBattleThreadReady(gs))
+				return lock;
+		}
+		lock.unlock(); //battle thread resumed before we got the lock, it must finish first
+	}
+}
+
+void CGameHandler::replay(const std::string & fname)
+{
+	logGlobal->info("Replaying packs recorded in %s", fname);
+	CLoadFile record(fname, MINIMAL_SERIALIZATION_VERSION);
+	loadCommonState(record);
+	deterministicRandom = true;
+	record >> *this;
+
+	prepareForRecordedPacks(record, gs);
+	record.serializer.smartPointerSerialization = false;
+
+	//there are no clients, all players behave as if they were handled by single connection
+	for(auto & player : gs->players)
+		connections[player.first] = nullptr;
+
+	struct PackTiming
+	{
+		int count = 0;
+		double total = 0, max = 0; //in milliseconds
+	};
+	std::map<std::string, PackTiming> timings;
+	auto measure = [&](const std::string & name, std::function<void()> action)
+	{
+		auto start = std::chrono::steady_clock::now();
+		action();
+		waitForBattleThread();
+		double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		auto & timing = timings[name];
+		timing.count++;
+		timing.total += time;
+		vstd::amax(timing.max, time);
+		logGlobal->info("%s: %.3f ms", name, time);
+	};
+
+	for(;;)
+	{
+		RecordedEvent event;
+		try
+		{
+			record >> event;
+		}
+		catch(std::exception & e)
+		{
+			logGlobal->warn("Record ended unexpectedly: %s", e.what());
+			break;
+		}
+
+		if(event.type == RecordedEvent::END)
+			break;
+
+		switch(event.type)
+		{
+		case RecordedEvent::NEW_TURN:
+			measure("NewTurn", [&]()
+			{
+				auto deterministicLock = lockForDeterministicApply();
+				newTurn();
+			});
+			break;
+		case RecordedEvent::PLAYER_TURN:
+			measure("PlayerTurn", [&]()
+			{
+				auto deterministicLock = lockForDeterministicApply();
+				giveTurn(event.player);
+			});
+			break;
+		case RecordedEvent::PACK:
+			{
+				CPack * pack = event.pack;
+				const std::string name = typeid(*pack).name();
+				measure(name, [&]()
+				{
+					auto deterministicLock = lockForDeterministicApply();
+					replayedPlayer = event.actingPlayer;
+					auto replayedPlayerGuard = vstd::makeScopeGuard([&]()
+					{
+						replayedPlayer.reset();
+					});
+
+					if(!isBlockedByQueries(pack, event.player))
+						applier->getApplier(typeList.getTypeID(pack))->applyOnGH(this, nullptr, pack, event.player);
+				});
+				vstd::clear_pointer(pack);
+			}
+			break;
+		default:
+			throw std::runtime_error("Unknown event in pack record!");
+		}
+	}
+
+	logGlobal->info("%-40s %8s %12s %12s %12s", "Event", "Count", "Total ms", "Average ms", "Max ms");
+	for(auto & timing : timings)
+	{
+		logGlobal->info("%-40s %8d %12.3f %12.3f %12.3f", timing.first, timing.second.count,
+			timing.second.total, timing.second.total / timing.second.count, timing.second.max);
+	}
+}
+
+bool CGameHandler::giveTurn(PlayerColor player)
+{
+	//if player runs out of time, he shouldn't get the turn (especially AI)
+	checkVictoryLossConditionsForAll();
+
+	PlayerState * playerState = &gs->players[player]; //can't copy CBonusSystemNode by value
+	if (playerState->status != EPlayerStatus::INGAME) //player lost at the beginning of his turn
+		return false;
+
+	states.setFlag(player, &PlayerStatus::makingTurn, true);
+
+	YourTurn yt;
+	yt.player = player;
+	//Change local daysWithoutCastle counter for local interface message //TODO: needed?
+	yt.daysWithoutCastle = playerState->daysWithoutCastle;
+	applyAndSend(&yt);
+	return true;
+}
+
+void CGameHandler::waitForSave()
+{
+	if(saveThread)
+	{
+		saveThread->join();
+		saveThread.reset();
 	}
 }
 
@@ -2835,6 +3230,9 @@ bool CGameHandler::arrangeStacks(ObjectInstanceID id1, ObjectInstanceID id2, ui8
 
 PlayerColor CGameHandler::getPlayerAt(CConnection *c) const
 {
+	if(!c && replayedPlayer)
+		return replayedPlayer.get(); //replayed packs have no connection, player was recorded with them
+
 	std::set<PlayerColor> all;
 	for (auto i=connections.cbegin(); i!=connections.cend(); i++)
 		if (i->second == c)
@@ -5674,6 +6072,11 @@ bool CGameHandler::swapStacks(const StackLocation &sl1, const StackLocation &sl2
 
 void CGameHandler::runBattle()
 {
+	//with deterministic random battle thread changes game state only while other threads wait for it, see lockForDeterministicApply
+	boost::unique_lock<boost::mutex> deterministicLock(deterministicMx, boost::defer_lock);
+	if(deterministicRandom)
+		deterministicLock.lock();
+
 	setBattle(gs->curB);
 	assert(gs->curB);
 	//TODO: pre-tactic stuff, call scripts etc.
@@ -5681,7 +6084,15 @@ void CGameHandler::runBattle()
 	//tactic round
 	{
 		while (gs->curB->tacticDistance && !battleResult.get())
+		{
+			setBattleThreadState(BATTLE_THREAD_IN_TACTICS);
+			if(deterministicLock)
+				deterministicLock.unlock();
 			boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+			if(deterministicRandom)
+				deterministicLock.lock();
+		}
+		setBattleThreadState(BATTLE_THREAD_BUSY);
 	}
 
 	//initial stacks appearance triggers, e.g. built-in bonus spells
@@ -5947,14 +6358,23 @@ void CGameHandler::runBattle()
 							return !next->alive();//active stack is dead
 						};
 
-						boost::unique_lock<boost::mutex> lock(battleMadeAction.mx);
-						battleMadeAction.data = false;
-						while (!actionWasMade())
+						if(deterministicLock)
+							deterministicLock.unlock();
 						{
-							battleMadeAction.cond.wait(lock);
-							if (battleGetStackByID(nextId, false) != next)
-								next = nullptr; //it may be removed, while we wait
+							boost::unique_lock<boost::mutex> lock(battleMadeAction.mx);
+							battleMadeAction.data = false;
+							battleThreadState = BATTLE_THREAD_AWAITS_ACTION;
+							battleMadeAction.cond.notify_all();
+							while (!actionWasMade())
+							{
+								battleMadeAction.cond.wait(lock);
+								if (battleGetStackByID(nextId, false) != next)
+									next = nullptr; //it may be removed, while we wait
+							}
+							battleThreadState = BATTLE_THREAD_BUSY;
 						}
+						if(deterministicRandom)
+							deterministicLock.lock(); //waits until the action is applied
 					}
 				}
 
@@ -6006,6 +6426,7 @@ void CGameHandler::runBattle()
 	}
 
 	endBattle(gs->curB->tile, gs->curB->battleGetFightingHero(0), gs->curB->battleGetFightingHero(1));
+	setBattleThreadState(BATTLE_THREAD_NOT_RUNNING);
 }
 
 bool CGameHandler::makeAutomaticAction(const CStack *stack, BattleAction &ba)
@@ -6531,6 +6952,8 @@ CGameHandler::FinishingBattleHelper::FinishingBattleHelper()
 
 CRandomGenerator & CGameHandler::getRandomGenerator()
 {
+	if(deterministicRandom)
+		return gs->getRandomGenerator();
 	return CRandomGenerator::getDefault();
 }
 
@@ -22,10 +22,13 @@ struct BattleResult;
 struct BattleAttack;
 struct BattleStackAttacked;
 struct CPack;
+struct RecordedEvent;
 struct Query;
 struct SetResources;
 struct NewStructures;
 class CGHeroInstance;
+class CSaveFile;
+class CMemorySaveFile;
 class IMarket;
 
 class SpellCastEnvironment;
@@ -221,7 +224,10 @@ public:
 	bool razeStructure(ObjectInstanceID tid, BuildingID bid);
 	bool disbandCreature( ObjectInstanceID id, SlotID pos );
 	bool arrangeStacks( ObjectInstanceID id1, ObjectInstanceID id2, ui8 what, SlotID p1, SlotID p2, si32 val, PlayerColor player);
-	void save(const std::string &fname);
+	void save(const std::string &fname); //server part of the save is written by a background thread
+	void waitForSave(); //blocks until the pending save is written
+	void startRecording(const std::string &fname); //saves current state, then every received pack and turn change is appended
+	void replay(const std::string &fname); //applies recorded packs without clients, logs time spent on each of them
 	void close();
 	void playerLeftGame(int cid);
 	void handleTimeEvents();
@@ -247,6 +253,8 @@ public:
 	void sendMessageToAll(const std::string &message);
 	void sendMessageTo(CConnection &c, const std::string &message);
 	void sendToAllClients(CPackForClient * info);
+	std::set<CConnection *> beginPackBatch(); //packs sent by calling thread to returned connections are coalesced until endPackBatch, other threads send theirs right away
+	void endPackBatch(const std::set<CConnection *> & batched);
 	void sendAndApply(CPackForClient * info) override;
 	void applyAndSend(CPackForClient * info);
 	void sendAndApply(CGarrisonOperationPack * info);
@@ -295,6 +303,20 @@ public:
 	CRandomGenerator & getRandomGenerator();
 
 private:
+	std::unique_ptr<boost::thread> saveThread; //writes last save to the disk
+	std::shared_ptr<CMemorySaveFile> deltaBase; //state that following saves are stored as difference against, accessed only by saveThread
+	boost::filesystem::path deltaBasePath;
+	std::unique_ptr<CSaveFile> packRecord; //set when incoming packs are recorded
+	boost::mutex packRecordMx;
+	std::atomic<bool> deterministicRandom; //random numbers come from game state, so replay of recorded packs gives same results
+	boost::mutex deterministicMx; //when random is deterministic, only one thread may change game state, in the same order as it is recorded
+	boost::optional<PlayerColor> replayedPlayer; //player at the connection replayed pack came from
+
+	void recordEvent(const RecordedEvent & event);
+	boost::unique_lock<boost::mutex> lockForDeterministicApply(); //locks deterministicMx when battle thread is ready, returns no lock if random is not deterministic
+	bool giveTurn(PlayerColor player); //returns false if player has lost before his turn
+	void waitForBattleThread(); //blocks until battle thread is ready for next action or there is no battle
+
 	std::list<PlayerColor> generatePlayerTurnOrder() const;
 	void makeStackDoNothing(const CStack * next);
 	void getVictoryLossMessage(PlayerColor player, const EVictoryLossCheckResult & victoryLossCheckResult, InfoWindow & out) const;
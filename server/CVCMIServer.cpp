@@ -15,6 +15,7 @@
 #include "../lib/mapping/CCampaignHandler.h"
 #include "../lib/CThreadHelper.h"
 #include "../lib/serializer/Connection.h"
+#include "../lib/serializer/CPackStatistics.h"
 #include "../lib/CModHandler.h"
 #include "../lib/CArtHandler.h"
 #include "../lib/CGeneralTextHandler.h"
@@ -263,7 +264,7 @@ void CPregameServer::sendPack(CConnection * pc, const CPackForSelectionScreen &
 	if(!pc->sendStop)
 	{
 		logNetwork->info("\tSending pack of type %s to %s", typeid(pack).name(), pc->toString());
-		*pc << &pack;
+		pc->sendPack(&pack);
 	}
 
 	if(dynamic_ptr_cast<QuitMenuWithoutStarting>(&pack))
@@ -542,7 +543,9 @@ static void handleCommandOptions(int argc, char *argv[])
 		("uuid", po::value<std::string>(), "")
 		("enable-shm-uuid", "use UUID for shared memory identifier")
 		("enable-shm", "enable usage of shared memory")
-		("port", po::value<ui16>(), "port at which server will listen to connections from client");
+		("port", po::value<ui16>(), "port at which server will listen to connections from client")
+		("record", po::value<std::string>(), "record game state and all received packs to given file")
+		("replay", po::value<std::string>(), "replay packs from given record without clients, log time spent on each of them and exit");
 
 	if(argc > 1)
 	{
@@ -625,9 +628,27 @@ int main(int argc, char * argv[])
 	preinitDLL(console);
 	settings.init();
 	logConfig.configure();
+	CPackStatistics::get().setEnabled(settings["general"]["packStatistics"].Bool());
 
 	loadDLLClasses();
 	srand ( (ui32)time(nullptr) );
+
+	if(cmdLineOptions.count("replay"))
+	{
+		try
+		{
+			CGameHandler gh;
+			gh.replay(cmdLineOptions["replay"].as<std::string>());
+		}
+		catch(std::exception & e)
+		{
+			logGlobal->error("Replay failed: %s", e.what());
+		}
+		vstd::clear_pointer(VLC);
+		CResourceHandler::clear();
+		return 0;
+	}
+
 	try
 	{
 		boost::asio::io_service io_service;
@@ -0,0 +1,127 @@
+/*
+ * CBonusSystemNodeTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/HeroBonus.h"
+
+/// Tree of nodes: root has children a and b, a has child a1
+class CBonusSystemNodeTest : public testing::Test
+{
+protected:
+	CBonusSystemNode root, a, b, a1;
+	int selectorCalls;
+
+	void SetUp() override
+	{
+		a.attachTo(&root);
+		b.attachTo(&root);
+		a1.attachTo(&a);
+		root.addNewBonus(makeBonus(Bonus::PRIMARY_SKILL, 0, 1));
+		selectorCalls = 0;
+
+		//fill caches of all nodes
+		for(const CBonusSystemNode * node : {&root, &a, &b, &a1})
+			recalculated(*node);
+	}
+
+	static std::shared_ptr<Bonus> makeBonus(Bonus::BonusType type, si32 subtype, si32 val)
+	{
+		return std::make_shared<Bonus>(Bonus::PERMANENT, type, Bonus::OTHER, val, 0, subtype);
+	}
+
+	/// Selector is evaluated only if cached result of query was dropped
+	bool recalculated(const CBonusSystemNode & node)
+	{
+		const int callsBefore = selectorCalls;
+		auto counting = [this](const Bonus * bonus) -> bool
+		{
+			selectorCalls++;
+			return bonus->type == Bonus::PRIMARY_SKILL;
+		};
+		node.getBonuses(CSelector(counting), BonusCacheKey::make(BonusCacheKey::TYPE_SOURCE, Bonus::PRIMARY_SKILL));
+		return selectorCalls != callsBefore;
+	}
+
+	void expectRecalculated(std::initializer_list<const CBonusSystemNode *> changed)
+	{
+		for(const CBonusSystemNode * node : {&root, &a, &b, &a1})
+			EXPECT_EQ(recalculated(*node), vstd::contains(changed, node));
+	}
+};
+
+TEST_F(CBonusSystemNodeTest, cachedQueryIsNotRecalculated)
+{
+	expectRecalculated({});
+}
+
+TEST_F(CBonusSystemNodeTest, addingBonusDropsCacheOfSubtreeOnly)
+{
+	a.addNewBonus(makeBonus(Bonus::PRIMARY_SKILL, 1, 2));
+	expectRecalculated({&a, &a1});
+	EXPECT_EQ(a1.valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL)), 3);
+	EXPECT_EQ(b.valOfBonuses(Selector::type(Bonus::PRIMARY_SKILL)), 1);
+}
+
+TEST_F(CBonusSystemNodeTest, removingBonusDropsCacheOfSubtreeOnly)
+{
+	auto bonus = makeBonus(Bonus::PRIMARY_SKILL, 1, 2);
+	b.addNewBonus(bonus);
+	expectRecalculated({&b});
+
+	b.removeBonus(bonus);
+	expectRecalculated({&b});
+}
+
+TEST_F(CBonusSystemNodeTest, changingBonusOfRootDropsAllCaches)
+{
+	root.addNewBonus(makeBonus(Bonus::PRIMARY_SKILL, 1, 2));
+	expectRecalculated({&root, &a, &b, &a1});
+}
+
+TEST_F(CBonusSystemNodeTest, reattachingDropsCacheOfMovedNodeOnly)
+{
+	a1.detachFrom(&a);
+	a1.attachTo(&b);
+	expectRecalculated({&a1});
+}
+
+TEST_F(CBonusSystemNodeTest, treeChangeDropsAllCaches)
+{
+	CBonusSystemNode::treeHasChanged();
+	expectRecalculated({&root, &a, &b, &a1});
+}
+
+TEST_F(CBonusSystemNodeTest, queriesWithDifferentKeysAreCachedSeparately)
+{
+	a.addNewBonus(makeBonus(Bonus::PRIMARY_SKILL, 1, 2));
+	a.addNewBonus(makeBonus(Bonus::PRIMARY_SKILL, -1, 4));
+
+	for(int i = 0; i < 2; i++)
+	{
+		EXPECT_EQ(a1.valOfBonuses(Selector::typeSubtype(Bonus::PRIMARY_SKILL, 0), BonusCacheKey::make(BonusCacheKey::TYPE_SUBTYPE, Bonus::PRIMARY_SKILL, 0, 0)), 1);
+		EXPECT_EQ(a1.valOfBonuses(Selector::typeSubtype(Bonus::PRIMARY_SKILL, 1), BonusCacheKey::make(BonusCacheKey::TYPE_SUBTYPE, Bonus::PRIMARY_SKILL, 0, 1)), 2);
+		EXPECT_EQ(a1.valOfBonuses(Selector::typeSubtype(Bonus::PRIMARY_SKILL, -1), BonusCacheKey::make(BonusCacheKey::TYPE_SUBTYPE, Bonus::PRIMARY_SKILL, 0, -1)), 4);
+	}
+}
+
+TEST(BonusCacheKeyTest, fieldsDoNotOverlap)
+{
+	using namespace BonusCacheKey;
+	const TBonusCacheKey key = make(TYPE_SUBTYPE_INFO, 1, 1, 1);
+	EXPECT_NE(key, make(TYPE_SUBTYPE, 1, 1, 1));
+	EXPECT_NE(key, make(TYPE_SUBTYPE_INFO, 2, 1, 1));
+	EXPECT_NE(key, make(TYPE_SUBTYPE_INFO, 1, 2, 1));
+	EXPECT_NE(key, make(TYPE_SUBTYPE_INFO, 1, 1, 2));
+	EXPECT_NE(key, make(TYPE_SUBTYPE_INFO, 1, 1, -1));
+
+	//negative subtype must not spill into other fields
+	EXPECT_EQ(make(TYPE_SUBTYPE, 0, 0, -1) >> 32, make(TYPE_SUBTYPE, 0, 0, 0) >> 32);
+	EXPECT_NE(make(NONE), make(TYPE_SUBTYPE));
+}
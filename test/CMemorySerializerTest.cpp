@@ -0,0 +1,84 @@
+/*
+ * CMemorySerializerTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/serializer/CMemorySerializer.h"
+
+/// Arrays of primitives are loaded in one read, vector<bool> is converted from bytes one by one
+class CMemorySerializerTest : public testing::Test
+{
+protected:
+	CMemorySerializer mem;
+	std::vector<si32> ints;
+	std::array<ui16, 5> shorts;
+	ui8 bytes[7];
+	std::vector<bool> flags;
+
+	void SetUp() override
+	{
+		//no value is same with its bytes reversed
+		for(si32 i = 0; i < 100; i++)
+			ints.push_back(i * 0x01020304 - 7);
+		for(size_t i = 0; i < shorts.size(); i++)
+			shorts[i] = 0x1234 + i;
+		for(size_t i = 0; i < ARRAY_COUNT(bytes); i++)
+			bytes[i] = 200 + i;
+		flags = {true, false, false, true, true};
+	}
+
+	template<typename T>
+	static T reversed(T value)
+	{
+		auto dataPtr = reinterpret_cast<char *>(&value);
+		std::reverse(dataPtr, dataPtr + sizeof(T));
+		return value;
+	}
+
+	/// Same bytes as save made on machine with other endianness
+	void saveReversed()
+	{
+		mem.oser & reversed<ui32>(ints.size());
+		for(si32 value : ints)
+			mem.oser & reversed(value);
+		for(ui16 value : shorts)
+			mem.oser & reversed(value);
+		mem.oser & bytes;
+		mem.oser & reversed<ui32>(flags.size());
+		for(bool flag : flags)
+			mem.oser & static_cast<ui8>(flag);
+	}
+
+	void expectLoadedSame()
+	{
+		std::vector<si32> loadedInts;
+		std::array<ui16, 5> loadedShorts;
+		ui8 loadedBytes[7];
+		std::vector<bool> loadedFlags(flags.size()); //loading vector<bool> keeps its size
+		mem.iser & loadedInts & loadedShorts & loadedBytes & loadedFlags;
+
+		EXPECT_EQ(loadedInts, ints);
+		EXPECT_EQ(loadedShorts, shorts);
+		EXPECT_TRUE(std::equal(bytes, bytes + ARRAY_COUNT(bytes), loadedBytes));
+		EXPECT_EQ(loadedFlags, flags);
+	}
+};
+
+TEST_F(CMemorySerializerTest, loadsArraysInNativeByteOrder)
+{
+	mem.oser & ints & shorts & bytes & flags;
+	expectLoadedSame();
+}
+
+TEST_F(CMemorySerializerTest, loadsArraysInReversedByteOrder)
+{
+	saveReversed();
+	mem.iser.reverseEndianess = true;
+	expectLoadedSame();
+}
@@ -0,0 +1,193 @@
+/*
+ * CPathfinderTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CPathfinder.h"
+#include "../lib/CGameState.h"
+#include "../lib/CPlayerState.h"
+#include "../lib/CRandomGenerator.h"
+#include "../lib/JsonNode.h"
+#include "../lib/VCMI_Lib.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+#include "../lib/mapObjects/CObjectClassesHandler.h"
+#include "../lib/mapObjects/MiscObjects.h"
+
+/// Checks that paths repaired around changed tiles are same as paths calculated from scratch
+class CPathfinderTest : public testing::Test
+{
+protected:
+	const int3 sizes = int3(12, 12, 1);
+	const PlayerColor player = PlayerColor(0);
+
+	CGameState gs;
+	CRandomGenerator rand;
+	CGHeroInstance * hero;
+	std::unique_ptr<CPathsInfo> paths;
+
+	void SetUp() override
+	{
+		auto map = new CMap();
+		map->width = sizes.x;
+		map->height = sizes.y;
+		map->twoLevel = false;
+		map->initTerrain();
+		for(int x = 0; x < sizes.x; x++)
+		{
+			for(int y = 0; y < sizes.y; y++)
+			{
+				TerrainTile & tile = map->getTile(int3(x, y, 0));
+				tile.terType = ETerrainType::GRASS;
+				tile.terView = 0;
+				tile.riverType = ERiverType::NO_RIVER;
+				tile.roadType = ERoadType::NO_ROAD;
+			}
+		}
+		gs.map = map;
+
+		PlayerState & state = gs.players[player];
+		state.color = player;
+		state.team = TeamID(0);
+		state.human = true;
+		TeamState & team = gs.teams[TeamID(0)];
+		team.id = TeamID(0);
+		team.players.insert(player);
+		team.fogOfWarMap.resize(sizes.x, std::vector<std::vector<ui8>>(sizes.y, std::vector<ui8>(sizes.z, 1)));
+
+		hero = new CGHeroInstance();
+		hero->ID = Obj::HERO;
+		hero->tempOwner = player;
+		hero->initHero(rand, HeroTypeID(0));
+		hero->pos = CGHeroInstance::convertPosition(int3(2, 2, 0), true);
+		hero->movement = hero->maxMovePoints(true);
+		addObject(hero);
+
+		paths = make_unique<CPathsInfo>(sizes);
+		gs.calculatePaths(hero, *paths);
+	}
+
+	void addObject(CGObjectInstance * obj)
+	{
+		obj->id = ObjectInstanceID(gs.map->objects.size());
+		obj->instanceName = "object_" + std::to_string(obj->id.getNum());
+		gs.map->addNewObject(obj);
+		gs.map->calculateGuardingGreaturePositions();
+	}
+
+	/// Object stays in map objects, so it's deleted with map
+	void removeObject(CGObjectInstance * obj)
+	{
+		gs.map->removeBlockVisTiles(obj, true);
+		gs.map->calculateGuardingGreaturePositions();
+	}
+
+	CGObjectInstance * addObstacle(const int3 & pos)
+	{
+		JsonNode mask;
+		mask["mask"].Vector().push_back(JsonNode());
+		mask["mask"].Vector().back().String() = "B";
+
+		auto obstacle = new CGObjectInstance();
+		obstacle->ID = Obj::HOLE;
+		obstacle->appearance.readJson(mask, false);
+		obstacle->pos = pos;
+		addObject(obstacle);
+		return obstacle;
+	}
+
+	CGCreature * addMonster(const int3 & pos)
+	{
+		auto handler = VLC->objtypeh->getHandlerFor(Obj::MONSTER, 0);
+		auto monster = dynamic_cast<CGCreature *>(handler->create(handler->getTemplates().front()));
+		monster->character = CGCreature::HOSTILE;
+		monster->putStack(SlotID(0), new CStackInstance(CreatureID(0), 10));
+		monster->pos = pos;
+		addObject(monster);
+		return monster;
+	}
+
+	/// Marks tiles of object as changed the same way as CPathsCache does, then repairs paths
+	void repairAround(const CGObjectInstance * obj)
+	{
+		for(auto & tile : obj->getBlockedPos())
+			paths->changedTiles.insert(tile);
+		paths->changedTiles.insert(obj->visitablePos());
+		gs.updatePaths(hero, *paths);
+	}
+
+	void expectSameAsFullCalculation()
+	{
+		CPathsInfo expected(sizes);
+		gs.calculatePaths(hero, expected);
+
+		EXPECT_EQ(paths->moveRemains, expected.moveRemains);
+		EXPECT_EQ(paths->turns, expected.turns);
+		EXPECT_EQ(paths->predecessors, expected.predecessors);
+		EXPECT_EQ(paths->accessible, expected.accessible);
+		EXPECT_EQ(paths->actions, expected.actions);
+		//repair falls back to full calculation when initial node isn't expanded, so locks must match too
+		EXPECT_EQ(paths->locked, expected.locked);
+	}
+};
+
+TEST_F(CPathfinderTest, obstacleAdded)
+{
+	auto obstacle = addObstacle(int3(4, 2, 0));
+	repairAround(obstacle);
+	expectSameAsFullCalculation();
+	EXPECT_EQ(paths->getNode(paths->getNodeIndex(int3(4, 2, 0), EPathfindingLayer::LAND)).accessible, CGPathNode::BLOCKED);
+}
+
+TEST_F(CPathfinderTest, obstacleRemoved)
+{
+	auto obstacle = addObstacle(int3(4, 2, 0));
+	gs.calculatePaths(hero, *paths);
+
+	removeObject(obstacle);
+	repairAround(obstacle);
+	expectSameAsFullCalculation();
+	EXPECT_TRUE(paths->getNode(paths->getNodeIndex(int3(4, 2, 0), EPathfindingLayer::LAND)).reachable());
+}
+
+TEST_F(CPathfinderTest, monsterGuardAdded)
+{
+	auto monster = addMonster(int3(6, 3, 0));
+	repairAround(monster);
+	expectSameAsFullCalculation();
+}
+
+TEST_F(CPathfinderTest, monsterGuardRemoved)
+{
+	auto monster = addMonster(int3(6, 3, 0));
+	gs.calculatePaths(hero, *paths);
+
+	removeObject(monster);
+	repairAround(monster);
+	expectSameAsFullCalculation();
+}
+
+TEST_F(CPathfinderTest, consecutiveRepairs)
+{
+	auto obstacle = addObstacle(int3(8, 8, 0));
+	repairAround(obstacle);
+	expectSameAsFullCalculation();
+
+	auto monster = addMonster(int3(5, 7, 0));
+	repairAround(monster);
+	expectSameAsFullCalculation();
+
+	removeObject(obstacle);
+	repairAround(obstacle);
+	expectSameAsFullCalculation();
+
+	removeObject(monster);
+	repairAround(monster);
+	expectSameAsFullCalculation();
+}
@@ -0,0 +1,122 @@
+/*
+ * CPathsCacheTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CPathfinder.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+
+/// Cache which only records calculations instead of running pathfinder on game state
+class PathsCacheMock : public CPathsCache
+{
+public:
+	std::vector<const CGHeroInstance *> calculated, updated;
+
+	PathsCacheMock()
+		: CPathsCache(nullptr, int3(4, 4, 1))
+	{
+	}
+
+protected:
+	void calculatePaths(const CGHeroInstance * hero, CPathsInfo & out) override
+	{
+		calculated.push_back(hero);
+		out.hero = hero;
+		out.changedTiles.clear();
+	}
+
+	void updatePaths(const CGHeroInstance * hero, CPathsInfo & out) override
+	{
+		updated.push_back(hero);
+		out.changedTiles.clear();
+	}
+
+	void calculatePaths(const std::map<const CGHeroInstance *, CPathsInfo *> & paths) override
+	{
+		for(auto & path : paths)
+			calculatePaths(path.first, *path.second);
+	}
+};
+
+struct CPathsCacheTest : testing::Test
+{
+	PathsCacheMock subject;
+	CGHeroInstance first, second, third;
+	std::vector<const CGHeroInstance *> heroes;
+
+	CPathsCacheTest()
+		: heroes{&first, &second, &third}
+	{
+	}
+};
+
+TEST_F(CPathsCacheTest, prepareCalculatesEveryUncachedHeroSeparately)
+{
+	subject.prepare(heroes);
+	EXPECT_EQ(subject.calculated.size(), heroes.size());
+
+	std::set<const CPathsInfo *> paths;
+	for(auto hero : heroes)
+	{
+		const CPathsInfo * pathInfo = subject.get(hero);
+		EXPECT_EQ(pathInfo->hero, hero);
+		paths.insert(pathInfo);
+	}
+	EXPECT_EQ(paths.size(), heroes.size());
+	EXPECT_EQ(subject.calculated.size(), heroes.size()); //get returned prepared paths without calculating them again
+}
+
+TEST_F(CPathsCacheTest, prepareReusesInvalidatedPaths)
+{
+	subject.prepare(heroes);
+	subject.invalidate();
+	subject.prepare(heroes);
+	EXPECT_EQ(subject.calculated.size(), 2 * heroes.size());
+
+	std::set<const CPathsInfo *> paths;
+	for(auto hero : heroes)
+	{
+		EXPECT_EQ(subject.get(hero)->hero, hero);
+		paths.insert(subject.get(hero));
+	}
+	EXPECT_EQ(paths.size(), heroes.size());
+}
+
+TEST_F(CPathsCacheTest, prepareOnlyUpdatesPathsAroundChangedTiles)
+{
+	subject.prepare(heroes);
+	subject.invalidate(std::unordered_set<int3, ShashInt3>{int3(1, 1, 0)});
+	subject.prepare(heroes);
+	EXPECT_EQ(subject.calculated.size(), heroes.size());
+	EXPECT_EQ(subject.updated.size(), heroes.size());
+}
+
+TEST_F(CPathsCacheTest, batchedInvalidationIsAppliedOnce)
+{
+	subject.prepare(heroes);
+	subject.beginInvalidationBatch();
+	subject.invalidate(std::unordered_set<int3, ShashInt3>{int3(1, 1, 0)});
+	subject.invalidate(&first);
+	subject.invalidate(std::unordered_set<int3, ShashInt3>{int3(2, 2, 0)});
+	subject.endInvalidationBatch();
+
+	subject.prepare(heroes);
+	EXPECT_EQ(subject.calculated.size(), heroes.size() + 1); //only paths of changed hero are dropped
+	EXPECT_EQ(subject.updated.size(), heroes.size() - 1);
+}
+
+TEST_F(CPathsCacheTest, getAppliesBatchedInvalidation)
+{
+	subject.prepare(heroes);
+	subject.beginInvalidationBatch();
+	subject.invalidate();
+	EXPECT_EQ(subject.get(&second)->hero, &second);
+	EXPECT_EQ(subject.calculated.size(), heroes.size() + 1);
+	subject.endInvalidationBatch();
+}
@@ -0,0 +1,101 @@
+/*
+ * CSaveFileTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CRandomGenerator.h"
+#include "../lib/serializer/BinaryDeserializer.h"
+#include "../lib/serializer/BinarySerializer.h"
+
+/// Round trips through save files, data is larger than read buffer of CLoadFile and compression buffer of CSaveFile
+class CSaveFileTest : public testing::Test
+{
+protected:
+	boost::filesystem::path dir;
+	boost::filesystem::path savePath;
+	std::string name;
+	std::vector<si32> data;
+	ui8 last;
+
+	void SetUp() override
+	{
+		dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-save-%%%%%%%%");
+		savePath = dir / "save.vsgm1";
+		boost::filesystem::create_directories(dir);
+
+		//random values barely compress, so compressed file is still several blocks long
+		CRandomGenerator rand;
+		rand.setSeed(42);
+		name = "test save";
+		data.resize(100 * 1000);
+		for(auto & value : data)
+			value = rand.nextInt();
+		last = 7;
+	}
+
+	void TearDown() override
+	{
+		boost::filesystem::remove_all(dir);
+	}
+
+	void save(bool compress)
+	{
+		CSaveFile file(savePath, compress);
+		file << name << data << last;
+	}
+
+	void expectLoadedSame()
+	{
+		std::string loadedName;
+		std::vector<si32> loadedData;
+		ui8 loadedLast = 0;
+
+		CLoadFile file(savePath);
+		file >> loadedName >> loadedData >> loadedLast;
+
+		EXPECT_EQ(loadedName, name);
+		EXPECT_EQ(loadedData, data);
+		EXPECT_EQ(loadedLast, last);
+	}
+};
+
+TEST_F(CSaveFileTest, uncompressedRoundTrip)
+{
+	save(false);
+	EXPECT_GT(boost::filesystem::file_size(savePath), 2 * 64 * 1024);
+	expectLoadedSame();
+}
+
+TEST_F(CSaveFileTest, compressedRoundTrip)
+{
+	save(true);
+	EXPECT_GT(boost::filesystem::file_size(savePath), 2 * 64 * 1024);
+	expectLoadedSame();
+}
+
+TEST_F(CSaveFileTest, compressedFileIsSmaller)
+{
+	std::fill(data.begin(), data.end(), 3);
+	save(false);
+	const auto uncompressedSize = boost::filesystem::file_size(savePath);
+	save(true);
+	EXPECT_LT(boost::filesystem::file_size(savePath), uncompressedSize / 10);
+	expectLoadedSame();
+}
+
+TEST_F(CSaveFileTest, truncatedCompressedFileThrows)
+{
+	save(true);
+	boost::filesystem::resize_file(savePath, boost::filesystem::file_size(savePath) / 2);
+
+	std::vector<si32> loadedData;
+	CLoadFile file(savePath);
+	file >> name;
+	EXPECT_THROW(file >> loadedData, std::runtime_error);
+}
@@ -0,0 +1,84 @@
+/*
+ * CThreadHelperTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CThreadHelper.h"
+#include "../lib/HeroBonus.h"
+
+/// Candidate action valued the way battle AI values spellcasts: by speed of a unit in some future turn
+struct Candidate
+{
+	int turn;
+	int weight;
+	int value;
+};
+
+struct ParallelEvaluationTest : testing::Test
+{
+	CBonusSystemNode unit;
+	std::vector<Candidate> candidates;
+
+	ParallelEvaluationTest()
+	{
+		unit.addNewBonus(std::make_shared<Bonus>(Bonus::PERMANENT, Bonus::STACKS_SPEED, Bonus::CREATURE_ABILITY, 5, 0));
+		for(int i = 1; i <= 4; i++)
+		{
+			auto haste = std::make_shared<Bonus>(Bonus::N_TURNS, Bonus::STACKS_SPEED, Bonus::SPELL_EFFECT, i, i);
+			haste->turnsRemain = i;
+			unit.addNewBonus(haste);
+		}
+
+		for(int i = 0; i < 500; i++)
+			candidates.push_back(Candidate{(i * 7) % 6, i % 5 + 1, 0});
+	}
+
+	//returns index of first candidate with maximal value
+	size_t evaluate(std::vector<Candidate> & evaluated, int threads)
+	{
+		evaluated = candidates;
+		parallelForEach(evaluated, [&](Candidate & candidate)
+		{
+			candidate.value = unit.Speed(candidate.turn) * candidate.weight;
+		}, threads);
+
+		return vstd::maxElementByFun(evaluated, [](const Candidate & candidate)
+		{
+			return candidate.value;
+		}) - evaluated.begin();
+	}
+};
+
+TEST_F(ParallelEvaluationTest, parallelEvaluationChoosesSameAsSerial)
+{
+	std::vector<Candidate> serial, parallel;
+	for(int attempt = 0; attempt < 20; attempt++)
+	{
+		unit.nodeHasChanged(); //drop cached speeds, so every attempt queries bonuses again
+		const size_t serialChoice = evaluate(serial, 1);
+		unit.nodeHasChanged();
+		const size_t parallelChoice = evaluate(parallel, 8);
+
+		EXPECT_EQ(serialChoice, parallelChoice);
+		for(size_t i = 0; i < candidates.size(); i++)
+			ASSERT_EQ(serial[i].value, parallel[i].value) << "candidate " << i << ", turn " << candidates[i].turn;
+	}
+}
+
+TEST_F(ParallelEvaluationTest, firstExceptionIsRethrownAfterAllCalls)
+{
+	std::atomic<int> calls(0);
+	EXPECT_THROW(parallelForEach(candidates, [&](Candidate & candidate)
+	{
+		calls++;
+		if(candidate.turn == 3)
+			throw std::runtime_error("evaluation failed");
+	}, 4), std::runtime_error);
+	EXPECT_EQ(calls, candidates.size());
+}
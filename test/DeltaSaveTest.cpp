@@ -0,0 +1,95 @@
+/*
+ * DeltaSaveTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/serializer/CMemorySerializer.h"
+
+class DeltaSaveTest : public testing::Test
+{
+protected:
+	boost::filesystem::path dir;
+	boost::filesystem::path basePath;
+	boost::filesystem::path savePath;
+	CMemorySaveFile base;
+	CMemorySaveFile snapshot;
+	std::vector<si32> data;
+
+	void SetUp() override
+	{
+		dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-delta-%%%%%%%%");
+		basePath = dir / "DeltaBases" / "base.vdbase";
+		savePath = dir / "save.vsgm1";
+		boost::filesystem::create_directories(basePath.parent_path());
+
+		data.resize(1000);
+		for(size_t i = 0; i < data.size(); i++)
+			data[i] = i;
+		base.serializer & data;
+		data[500] = -1;
+		snapshot.serializer & data;
+
+		{
+			CSaveFile baseFile(basePath);
+			base.writeTo(baseFile);
+		}
+		ASSERT_TRUE(snapshot.writeDeltaTo(savePath, false, base, basePath));
+	}
+
+	void TearDown() override
+	{
+		boost::filesystem::remove_all(dir);
+	}
+};
+
+TEST_F(DeltaSaveTest, loadsDataStoredAgainstBaseInSubdirectory)
+{
+	std::vector<si32> loaded;
+	CLoadFile save(savePath);
+	save >> loaded;
+
+	EXPECT_EQ(save.deltaBase, basePath);
+	EXPECT_EQ(loaded, data);
+}
+
+TEST_F(DeltaSaveTest, baseIsFoundAfterDirectoryIsMoved)
+{
+	auto movedDir = dir.string() + "-moved";
+	boost::filesystem::rename(dir, movedDir);
+	dir = movedDir;
+
+	std::vector<si32> loaded;
+	CLoadFile save(dir / savePath.filename());
+	save >> loaded;
+
+	EXPECT_EQ(loaded, data);
+}
+
+TEST_F(DeltaSaveTest, baseIsReportedWithoutLoadingIt)
+{
+	boost::filesystem::remove(basePath);
+
+	CLoadFile save(savePath, SERIALIZATION_VERSION, false);
+	EXPECT_EQ(save.deltaBase, basePath);
+}
+
+TEST_F(DeltaSaveTest, missingBaseIsReported)
+{
+	boost::filesystem::remove(basePath);
+
+	try
+	{
+		CLoadFile save(savePath);
+		FAIL() << "Delta save loaded without its base";
+	}
+	catch(std::runtime_error & e)
+	{
+		EXPECT_NE(std::string(e.what()).find("missing"), std::string::npos) << e.what();
+	}
+}
@@ -0,0 +1,112 @@
+/*
+ * PackRecordTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/NetPacks.h"
+#include "../lib/serializer/CMemorySerializer.h"
+#include "../lib/serializer/PackRecord.h"
+
+class PackRecordTest : public testing::Test
+{
+protected:
+	CMemorySerializer record;
+	std::vector<std::unique_ptr<CPack>> replayedPacks;
+
+	void SetUp() override
+	{
+		//same as server: packs are deleted after being applied, their addresses get reused
+		record.oser.smartPointerSerialization = false;
+		record.iser.smartPointerSerialization = false;
+	}
+
+	void write(const RecordedEvent & event)
+	{
+		record.oser & event;
+	}
+
+	RecordedEvent replay()
+	{
+		RecordedEvent event;
+		record.iser & event;
+		if(event.pack)
+			replayedPacks.push_back(std::unique_ptr<CPack>(event.pack));
+		return event;
+	}
+};
+
+TEST_F(PackRecordTest, replayGivesRecordedEventsInOrder)
+{
+	MoveHero move(int3(3, 4, 0), ObjectInstanceID(12), false);
+	JsonNode answer(JsonNode::DATA_INTEGER);
+	answer.Integer() = 1;
+	QueryReply reply(QueryID(7), answer);
+	reply.player = PlayerColor(1);
+
+	RecordedEvent moveEvent(RecordedEvent::PACK, PlayerColor(0));
+	moveEvent.actingPlayer = PlayerColor(0);
+	moveEvent.pack = &move;
+	//defender answers during attacker's turn, its connection is not the current player's one
+	RecordedEvent replyEvent(RecordedEvent::PACK, PlayerColor(1));
+	replyEvent.actingPlayer = PlayerColor(1);
+	replyEvent.pack = &reply;
+
+	write(RecordedEvent(RecordedEvent::NEW_TURN));
+	write(RecordedEvent(RecordedEvent::PLAYER_TURN, PlayerColor(0)));
+	write(moveEvent);
+	write(replyEvent);
+	write(RecordedEvent(RecordedEvent::END));
+
+	auto event = replay();
+	EXPECT_EQ(event.type, RecordedEvent::NEW_TURN);
+	EXPECT_EQ(event.pack, nullptr);
+
+	event = replay();
+	EXPECT_EQ(event.type, RecordedEvent::PLAYER_TURN);
+	EXPECT_EQ(event.player, PlayerColor(0));
+
+	event = replay();
+	ASSERT_EQ(event.type, RecordedEvent::PACK);
+	EXPECT_EQ(event.player, PlayerColor(0));
+	EXPECT_EQ(event.actingPlayer, PlayerColor(0));
+	auto replayedMove = dynamic_cast<MoveHero *>(event.pack);
+	ASSERT_NE(replayedMove, nullptr);
+	EXPECT_EQ(replayedMove->dest, move.dest);
+	EXPECT_EQ(replayedMove->hid, move.hid);
+
+	event = replay();
+	ASSERT_EQ(event.type, RecordedEvent::PACK);
+	EXPECT_EQ(event.player, PlayerColor(1));
+	EXPECT_EQ(event.actingPlayer, PlayerColor(1));
+	auto replayedReply = dynamic_cast<QueryReply *>(event.pack);
+	ASSERT_NE(replayedReply, nullptr);
+	EXPECT_EQ(replayedReply->qid, reply.qid);
+	EXPECT_EQ(replayedReply->player, reply.player);
+	EXPECT_EQ(replayedReply->reply.Integer(), 1);
+
+	event = replay();
+	EXPECT_EQ(event.type, RecordedEvent::END);
+}
+
+TEST_F(PackRecordTest, sameAddressIsRecordedAsSeparatePacks)
+{
+	MoveHero move(int3(1, 1, 0), ObjectInstanceID(3), false);
+	RecordedEvent event(RecordedEvent::PACK, PlayerColor(2));
+	event.actingPlayer = PlayerColor(2);
+	event.pack = &move;
+	write(event);
+	move.dest = int3(2, 2, 0);
+	write(event);
+
+	auto first = replay();
+	auto second = replay();
+	ASSERT_NE(first.pack, second.pack);
+	EXPECT_EQ(dynamic_cast<MoveHero *>(first.pack)->dest, int3(1, 1, 0));
+	EXPECT_EQ(dynamic_cast<MoveHero *>(second.pack)->dest, int3(2, 2, 0));
+}
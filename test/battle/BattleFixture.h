@@ -0,0 +1,79 @@
+/*
+ * BattleFixture.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "../lib/battle/BattleInfo.h"
+#include "../lib/battle/CObstacleInstance.h"
+#include "../lib/CStack.h"
+#include "../lib/mapObjects/CArmedInstance.h"
+
+const CreatureID PIKEMAN(0);
+const CreatureID ARCHER(2);
+const CreatureID GRIFFIN(4);
+const CreatureID SWORDSMAN(6);
+
+/// Gives tests access to protected parts of battle callback
+struct FixtureBattle : BattleInfo
+{
+	using CBattleInfoEssentials::battleGetGeneration;
+	using CBattleInfoCallback::makeBFS;
+	using CBattleInfoCallback::getStoppers;
+};
+
+/// Field battle between two armies without heroes, tests place stacks and obstacles on it
+class BattleFixture : public testing::Test
+{
+protected:
+	FixtureBattle battle;
+	CArmedInstance armies[2];
+
+	void SetUp() override
+	{
+		battle.round = 0;
+		battle.terrainType = ETerrainType::DIRT; //no stack is native, so quicksands stay hidden from the other side
+		battle.battlefieldType = BFieldType::DIRT_BIRCHES;
+		for(ui8 side : {BattleSide::ATTACKER, BattleSide::DEFENDER})
+		{
+			armies[side].tempOwner = PlayerColor(side);
+			battle.sides[side].color = PlayerColor(side);
+			battle.sides[side].armyObject = &armies[side];
+		}
+		battle.localInit();
+	}
+
+	void TearDown() override
+	{
+		for(CStack * stack : battle.stacks)
+			delete stack;
+		battle.stacks.clear();
+	}
+
+	const CStack * addStack(CreatureID creature, int count, ui8 side, BattleHex position)
+	{
+		auto stack = battle.generateNewStack(CStackBasicDescriptor(creature, count), side, SlotID(battle.stacks.size()), position);
+		battle.stacks.push_back(stack);
+		stack->localInit(&battle);
+		battle.stateChanged();
+		return stack;
+	}
+
+	void addQuicksand(BattleHex position, ui8 casterSide)
+	{
+		auto obstacle = std::make_shared<SpellCreatedObstacle>();
+		obstacle->obstacleType = CObstacleInstance::QUICKSAND;
+		obstacle->pos = position;
+		obstacle->uniqueID = battle.obstacles.size();
+		obstacle->casterSide = casterSide;
+		obstacle->visibleForAnotherSide = false;
+		battle.obstacles.push_back(obstacle);
+		battle.stateChanged();
+	}
+};
@@ -10,6 +10,8 @@
 
 #include "StdInc.h"
 #include "../lib/battle/BattleHex.h"
+#include "../lib/battle/AccessibilityInfo.h"
+#include "../lib/GameConstants.h"
 
 TEST(BattleHexTest, getNeighbouringTiles){
 	BattleHex mainHex;
@@ -116,3 +118,54 @@ TEST(BattleHexTest, moveEDir)
 	mainHex.moveInDirection(BattleHex::EDir::BOTTOM_LEFT);
 	EXPECT_EQ(mainHex, 20);
 }
+
+TEST(BattleHexTest, neighbourTableMatchesGeometry)
+{
+	for(si16 i = 0; i < GameConstants::BFIELD_SIZE; i++)
+	{
+		BattleHex mainHex(i);
+		std::vector<BattleHex> expected;
+		for(auto dir = BattleHex::EDir(0); dir <= BattleHex::EDir(5); dir = BattleHex::EDir(dir+1))
+			BattleHex::checkAndPush(mainHex.cloneInDirection(dir, false), expected);
+
+		std::vector<BattleHex> fromTable(mainHex.neighbours().begin(), mainHex.neighbours().end());
+		EXPECT_EQ(fromTable, expected);
+		EXPECT_EQ(mainHex.neighbouringTiles(), expected);
+	}
+}
+
+TEST(BattleHexTest, distanceTableMatchesGeometry)
+{
+	for(si16 i = 0; i < GameConstants::BFIELD_SIZE; i++)
+	{
+		for(si16 j = 0; j < GameConstants::BFIELD_SIZE; j++)
+		{
+			BattleHex firstHex(i), secondHex(j);
+			int y1 = firstHex.getY(), y2 = secondHex.getY();
+			int x1 = (firstHex.getX() + y1 * 0.5), x2 = (secondHex.getX() + y2 * 0.5);
+			int xDst = x2 - x1, yDst = y2 - y1;
+			int expected = ((xDst >= 0 && yDst >= 0) || (xDst < 0 && yDst < 0)) ? std::max(std::abs(xDst), std::abs(yDst)) : std::abs(xDst) + std::abs(yDst);
+
+			EXPECT_EQ((int)BattleHex::getDistance(firstHex, secondHex), expected);
+		}
+	}
+}
+
+TEST(BattleHexTest, neighbourTilesOfHexSet)
+{
+	TBattleHexSet all;
+	for(si16 i = 0; i < GameConstants::BFIELD_SIZE; i++)
+	{
+		BattleHex mainHex(i);
+		TBattleHexSet single, expected;
+		single.set(i);
+		for(BattleHex neighbour : mainHex.neighbours())
+			expected.set(neighbour);
+
+		EXPECT_EQ(AccessibilityInfo::neighbourTiles(single), expected);
+		all |= expected;
+	}
+	TBattleHexSet everything;
+	everything.set();
+	EXPECT_EQ(AccessibilityInfo::neighbourTiles(everything), all);
+}
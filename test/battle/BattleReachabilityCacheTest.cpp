@@ -0,0 +1,189 @@
+/*
+ * BattleReachabilityCacheTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "BattleFixture.h"
+#include "../lib/CGameState.h"
+#include "../lib/NetPacks.h"
+#include "../lib/mapObjects/CGTownInstance.h"
+
+/// Checks that results cached by CBattleInfoCallback are dropped by every netpack changing battlefield
+class BattleReachabilityCacheTest : public BattleFixture
+{
+protected:
+	CGameState gs;
+	CGTownInstance town;
+	const CStack * observer; //stack whose reachability is checked
+	const CStack * target; //stack changed by netpacks
+
+	void SetUp() override
+	{
+		BattleFixture::SetUp();
+		gs.curB = &battle;
+
+		observer = addStack(PIKEMAN, 10, BattleSide::ATTACKER, BattleHex(2, 5));
+		target = addStack(SWORDSMAN, 5, BattleSide::DEFENDER, BattleHex(6, 5));
+	}
+
+	void TearDown() override
+	{
+		gs.curB = nullptr;
+		BattleFixture::TearDown();
+	}
+
+	std::shared_ptr<SpellCreatedObstacle> makeForceField(BattleHex position)
+	{
+		auto obstacle = std::make_shared<SpellCreatedObstacle>();
+		obstacle->obstacleType = CObstacleInstance::FORCE_FIELD;
+		obstacle->pos = position;
+		obstacle->uniqueID = battle.obstacles.size();
+		obstacle->casterSide = BattleSide::DEFENDER;
+		obstacle->spellLevel = 0;
+		obstacle->visibleForAnotherSide = true;
+		return obstacle;
+	}
+
+	void startSiege()
+	{
+		town.builtBuildings.insert(BuildingID::FORT);
+		battle.town = &town;
+		for(auto & state : battle.si.wallState)
+			state = EWallState::INTACT;
+		battle.si.gateState = EGateState::CLOSED;
+		battle.stateChanged();
+	}
+
+	/// Results computed while battle is being set up are never cached
+	template<typename Query>
+	auto uncached(Query query) -> decltype(query())
+	{
+		const si32 round = battle.round;
+		battle.round = -2;
+		auto ret = query();
+		battle.round = round;
+		return ret;
+	}
+
+	static void expectSameReachability(const ReachabilityInfo & actual, const ReachabilityInfo & expected)
+	{
+		EXPECT_EQ(actual.accessibility, expected.accessibility);
+		EXPECT_EQ(actual.distances, expected.distances);
+		EXPECT_EQ(actual.predecessors, expected.predecessors);
+	}
+
+	void expectFreshResultsAfter(CPackForClient & pack, const ReachabilityInfo::Parameters & params)
+	{
+		const AccessibilityInfo accessibility = battle.getAccesibility();
+		const ReachabilityInfo reachability = battle.getReachability(params);
+		EXPECT_EQ(battle.getAccesibility(), accessibility);
+		expectSameReachability(battle.getReachability(params), reachability);
+
+		const ui64 generation = battle.battleGetGeneration();
+		gs.apply(&pack);
+		EXPECT_NE(battle.battleGetGeneration(), generation);
+
+		EXPECT_NE(battle.getAccesibility(), accessibility);
+		EXPECT_EQ(battle.getAccesibility(), uncached([&](){ return battle.getAccesibility(); }));
+		expectSameReachability(battle.getReachability(params), uncached([&](){ return battle.getReachability(params); }));
+
+		//repeated query of new generation gives the same result
+		expectSameReachability(battle.getReachability(params), battle.getReachability(params));
+	}
+
+	void expectFreshResultsAfter(CPackForClient & pack)
+	{
+		expectFreshResultsAfter(pack, ReachabilityInfo::Parameters(observer));
+	}
+};
+
+TEST_F(BattleReachabilityCacheTest, stackMoved)
+{
+	BattleStackMoved pack;
+	pack.stack = target->ID;
+	pack.tilesToMove = {BattleHex(4, 5)};
+	pack.distance = 2;
+	expectFreshResultsAfter(pack);
+	EXPECT_EQ(battle.getAccesibility()[BattleHex(4, 5)], EAccessibility::ALIVE_STACK);
+}
+
+TEST_F(BattleReachabilityCacheTest, stackKilled)
+{
+	BattleStackAttacked pack;
+	pack.stackAttacked = target->ID;
+	pack.attackerID = observer->ID;
+	pack.killedAmount = target->getCount();
+	pack.flags = BattleStackAttacked::KILLED;
+	expectFreshResultsAfter(pack);
+	EXPECT_EQ(battle.getAccesibility()[BattleHex(6, 5)], EAccessibility::ACCESSIBLE);
+}
+
+TEST_F(BattleReachabilityCacheTest, stackAdded)
+{
+	BattleStackAdded pack;
+	pack.side = BattleSide::DEFENDER;
+	pack.creID = PIKEMAN;
+	pack.amount = 5;
+	pack.pos = BattleHex(4, 4);
+	expectFreshResultsAfter(pack);
+	EXPECT_EQ(battle.getAccesibility()[BattleHex(4, 4)], EAccessibility::ALIVE_STACK);
+}
+
+TEST_F(BattleReachabilityCacheTest, stackRemoved)
+{
+	BattleStacksRemoved pack;
+	pack.stackIDs.insert(target->ID);
+	expectFreshResultsAfter(pack);
+	EXPECT_EQ(battle.getAccesibility()[BattleHex(6, 5)], EAccessibility::ACCESSIBLE);
+}
+
+TEST_F(BattleReachabilityCacheTest, obstaclePlaced)
+{
+	BattleObstaclePlaced pack;
+	pack.obstacle = makeForceField(BattleHex(4, 5));
+	expectFreshResultsAfter(pack);
+	EXPECT_EQ(battle.getAccesibility()[BattleHex(4, 5)], EAccessibility::OBSTACLE);
+}
+
+TEST_F(BattleReachabilityCacheTest, obstacleRemoved)
+{
+	auto obstacle = makeForceField(BattleHex(4, 5));
+	battle.obstacles.push_back(obstacle);
+	battle.stateChanged();
+
+	ObstaclesRemoved pack;
+	pack.obstacles.insert(obstacle->uniqueID);
+	expectFreshResultsAfter(pack);
+	EXPECT_EQ(battle.getAccesibility()[BattleHex(4, 5)], EAccessibility::ACCESSIBLE);
+}
+
+TEST_F(BattleReachabilityCacheTest, wallDestroyed)
+{
+	startSiege();
+
+	CatapultAttack::AttackInfo attack;
+	attack.destinationTile = ESiegeHex::DESTRUCTIBLE_WALL_4;
+	attack.attackedPart = EWallPart::BOTTOM_WALL;
+	attack.damageDealt = 2;
+
+	CatapultAttack pack;
+	pack.attackedParts.push_back(attack);
+	expectFreshResultsAfter(pack);
+	EXPECT_EQ(battle.getAccesibility()[ESiegeHex::DESTRUCTIBLE_WALL_4], EAccessibility::ACCESSIBLE);
+}
+
+TEST_F(BattleReachabilityCacheTest, gateOpened)
+{
+	startSiege();
+
+	BattleUpdateGateState pack;
+	pack.state = EGateState::OPENED;
+	expectFreshResultsAfter(pack, ReachabilityInfo::Parameters(target));
+	EXPECT_EQ(battle.getAccesibility()[ESiegeHex::GATE_INNER], EAccessibility::ACCESSIBLE);
+}
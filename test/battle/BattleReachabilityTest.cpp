@@ -0,0 +1,166 @@
+/*
+ * BattleReachabilityTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "BattleFixture.h"
+#include "../lib/CRandomGenerator.h"
+
+namespace
+{
+	/// Queue based search which makeBFS used before, paths found by it must not change
+	ReachabilityInfo referenceBFS(const FixtureBattle & battle, const AccessibilityInfo & accessibility, const ReachabilityInfo::Parameters & params)
+	{
+		ReachabilityInfo ret;
+		ret.accessibility = accessibility;
+		ret.params = params;
+
+		ret.predecessors.fill(BattleHex::INVALID);
+		ret.distances.fill(ReachabilityInfo::INFINITE_DIST);
+
+		const std::set<BattleHex> quicksands = battle.getStoppers(params.perspective);
+
+		std::queue<BattleHex> hexq;
+		hexq.push(params.startPosition);
+		ret.distances[params.startPosition] = 0;
+
+		while(!hexq.empty())
+		{
+			const BattleHex curHex = hexq.front();
+			hexq.pop();
+
+			if(curHex != params.startPosition && vstd::contains(quicksands, curHex))
+				continue;
+
+			const int costToNeighbour = ret.distances[curHex] + 1;
+			for(BattleHex neighbour : curHex.neighbouringTiles())
+			{
+				const bool accessible = accessibility.accessible(neighbour, params.doubleWide, params.side);
+				const int costFoundSoFar = ret.distances[neighbour];
+
+				if(accessible && costToNeighbour < costFoundSoFar)
+				{
+					hexq.push(neighbour);
+					ret.distances[neighbour] = costToNeighbour;
+					ret.predecessors[neighbour] = curHex;
+				}
+			}
+		}
+		return ret;
+	}
+}
+
+class BattleReachabilityTest : public BattleFixture
+{
+protected:
+	CRandomGenerator rand;
+
+	void SetUp() override
+	{
+		BattleFixture::SetUp();
+		rand.setSeed(42);
+	}
+
+	/// Side columns as on real battlefield, other tiles are random with most of them free
+	AccessibilityInfo randomAccessibility(bool withGate)
+	{
+		AccessibilityInfo ret;
+		for(si16 i = 0; i < GameConstants::BFIELD_SIZE; i++)
+		{
+			const si16 x = BattleHex(i).getX();
+			if(x == 0 || x == GameConstants::BFIELD_WIDTH - 1)
+				ret[i] = EAccessibility::SIDE_COLUMN;
+			else
+			{
+				static const EAccessibility blocked[] = {EAccessibility::ALIVE_STACK, EAccessibility::OBSTACLE, EAccessibility::GATE, EAccessibility::UNAVAILABLE};
+				ret[i] = rand.nextInt(3) ? EAccessibility::ACCESSIBLE : blocked[rand.nextInt(3)];
+			}
+		}
+		if(withGate)
+		{
+			ret[ESiegeHex::GATE_OUTER] = EAccessibility::GATE;
+			ret[ESiegeHex::GATE_INNER] = EAccessibility::GATE;
+		}
+		return ret;
+	}
+
+	BattleHex randomTile()
+	{
+		return BattleHex(rand.nextInt(1, GameConstants::BFIELD_WIDTH - 2), rand.nextInt(GameConstants::BFIELD_HEIGHT - 1));
+	}
+
+	void expectSameAsReference(const AccessibilityInfo & accessibility, const ReachabilityInfo::Parameters & params)
+	{
+		const ReachabilityInfo actual = battle.makeBFS(accessibility, params);
+		const ReachabilityInfo expected = referenceBFS(battle, accessibility, params);
+		EXPECT_EQ(actual.distances, expected.distances);
+		EXPECT_EQ(actual.predecessors, expected.predecessors);
+	}
+
+	/// Checks every kind of stack: single and double wide, on both sides
+	void expectSameAsReference(const AccessibilityInfo & accessibility, BattleHex start)
+	{
+		for(ui8 side : {BattleSide::ATTACKER, BattleSide::DEFENDER})
+		{
+			for(bool doubleWide : {false, true})
+			{
+				ReachabilityInfo::Parameters params;
+				params.side = side;
+				params.doubleWide = doubleWide;
+				params.startPosition = start;
+				params.perspective = BattlePerspective::BattlePerspective(side);
+				SCOPED_TRACE(boost::str(boost::format("start %d, side %d, double wide %d") % start.hex % (int)side % doubleWide));
+				expectSameAsReference(accessibility, params);
+			}
+		}
+	}
+};
+
+TEST_F(BattleReachabilityTest, emptyBattlefield)
+{
+	const AccessibilityInfo accessibility = randomAccessibility(false);
+	AccessibilityInfo empty;
+	for(si16 i = 0; i < GameConstants::BFIELD_SIZE; i++)
+		empty[i] = accessibility[i] == EAccessibility::SIDE_COLUMN ? EAccessibility::SIDE_COLUMN : EAccessibility::ACCESSIBLE;
+
+	for(BattleHex start : {BattleHex(1, 0), BattleHex(1, 5), BattleHex(15, 5), BattleHex(15, 10), BattleHex(8, 5)})
+		expectSameAsReference(empty, start);
+}
+
+TEST_F(BattleReachabilityTest, siegeGate)
+{
+	for(int map = 0; map < 50; map++)
+	{
+		const AccessibilityInfo accessibility = randomAccessibility(true);
+		for(BattleHex start : {BattleHex(ESiegeHex::GATE_BRIDGE), BattleHex(ESiegeHex::GATE_INNER + 1), randomTile()})
+			expectSameAsReference(accessibility, start);
+	}
+}
+
+TEST_F(BattleReachabilityTest, quicksands)
+{
+	for(int map = 0; map < 50; map++)
+	{
+		battle.obstacles.clear();
+		for(int i = 0; i < 8; i++)
+			addQuicksand(randomTile(), rand.nextInt(1));
+
+		const AccessibilityInfo accessibility = randomAccessibility(rand.nextInt(1));
+		expectSameAsReference(accessibility, randomTile());
+	}
+}
+
+TEST_F(BattleReachabilityTest, randomBattlefields)
+{
+	for(int map = 0; map < 200; map++)
+	{
+		const AccessibilityInfo accessibility = randomAccessibility(rand.nextInt(1));
+		expectSameAsReference(accessibility, randomTile());
+	}
+}
@@ -0,0 +1,159 @@
+/*
+ * BattleStateSnapshotTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "BattleFixture.h"
+#include "../lib/CRandomGenerator.h"
+#include "../lib/battle/BattleStateSnapshot.h"
+
+class BattleStateSnapshotTest : public BattleFixture
+{
+protected:
+	typedef BattleStateSnapshot::THexSet THexSet;
+
+	static BattleStateSnapshot::Unit & unitOf(BattleStateSnapshot & snapshot, const CStack * stack)
+	{
+		auto unit = snapshot.find(stack);
+		assert(unit);
+		return *unit;
+	}
+
+	static THexSet toSet(const std::vector<BattleHex> & hexes)
+	{
+		THexSet ret;
+		for(BattleHex hex : hexes)
+			ret.set(hex);
+		return ret;
+	}
+
+	static THexSet withinRange(const ReachabilityInfo & reachability, int range)
+	{
+		THexSet ret;
+		for(int i = 0; i < GameConstants::BFIELD_SIZE; i++)
+			ret[i] = reachability.distances[i] <= range;
+		return ret;
+	}
+};
+
+TEST_F(BattleStateSnapshotTest, reachabilityMatchesBattle)
+{
+	std::vector<const CStack *> stacks =
+	{
+		addStack(PIKEMAN, 10, BattleSide::ATTACKER, BattleHex(1, 2)),
+		addStack(CreatureID::CAVALIER, 2, BattleSide::ATTACKER, BattleHex(3, 6)),
+		addStack(SWORDSMAN, 5, BattleSide::DEFENDER, BattleHex(15, 2)),
+		addStack(GRIFFIN, 4, BattleSide::DEFENDER, BattleHex(14, 8)),
+		addStack(PIKEMAN, 10, BattleSide::DEFENDER, BattleHex(10, 5))
+	};
+	ASSERT_TRUE(stacks[1]->doubleWide());
+	ASSERT_TRUE(stacks[3]->doubleWide());
+	ASSERT_TRUE(stacks[3]->hasBonusOfType(Bonus::FLYING));
+
+	//each quicksand is known only to its caster
+	addQuicksand(BattleHex(3, 2), BattleSide::ATTACKER);
+	addQuicksand(BattleHex(13, 2), BattleSide::DEFENDER);
+	addQuicksand(BattleHex(8, 5), BattleSide::ATTACKER);
+
+	BattleStateSnapshot snapshot(&battle);
+	EXPECT_TRUE(snapshot.quicksands[BattleSide::ATTACKER][BattleHex(3, 2)]);
+	EXPECT_FALSE(snapshot.quicksands[BattleSide::DEFENDER][BattleHex(3, 2)]);
+	EXPECT_TRUE(snapshot.quicksands[BattleSide::DEFENDER][BattleHex(13, 2)]);
+
+	for(const CStack * stack : stacks)
+	{
+		EXPECT_EQ(snapshot.reachableHexes(unitOf(snapshot, stack)), toSet(battle.battleGetAvailableHexes(stack, false)))
+			<< "Wrong reachability of " << stack->nodeName();
+	}
+}
+
+TEST_F(BattleStateSnapshotTest, reachabilityFollowsMovedUnits)
+{
+	const CStack * pikeman = addStack(PIKEMAN, 10, BattleSide::ATTACKER, BattleHex(4, 5));
+	const CStack * swordsman = addStack(SWORDSMAN, 5, BattleSide::DEFENDER, BattleHex(8, 5));
+
+	BattleStateSnapshot snapshot(&battle);
+	snapshot.move(unitOf(snapshot, swordsman), BattleHex(5, 5));
+
+	const auto & attacker = unitOf(snapshot, pikeman);
+	auto accessibility = snapshot.accessibility(&attacker);
+	EXPECT_EQ(accessibility[BattleHex(5, 5)], EAccessibility::ALIVE_STACK);
+	EXPECT_EQ(accessibility[BattleHex(8, 5)], EAccessibility::ACCESSIBLE);
+
+	ReachabilityInfo::Parameters params(pikeman);
+	EXPECT_EQ(snapshot.reachableHexes(attacker), withinRange(battle.makeBFS(accessibility, params), attacker.speed));
+}
+
+TEST_F(BattleStateSnapshotTest, gateOpensOnlyForDefender)
+{
+	const CStack * pikeman = addStack(PIKEMAN, 10, BattleSide::ATTACKER, BattleHex(6, 5));
+	const CStack * swordsman = addStack(SWORDSMAN, 5, BattleSide::DEFENDER, BattleHex(10, 5));
+
+	BattleStateSnapshot snapshot(&battle);
+	const BattleHex gate(8, 5);
+	for(int y = 0; y < GameConstants::BFIELD_HEIGHT; y++)
+		snapshot.terrain[BattleHex(8, y)] = EAccessibility::UNAVAILABLE;
+	snapshot.terrain[gate] = EAccessibility::GATE;
+
+	for(const CStack * stack : {pikeman, swordsman})
+	{
+		const auto & unit = unitOf(snapshot, stack);
+		ReachabilityInfo::Parameters params(stack);
+		auto expected = withinRange(battle.makeBFS(snapshot.accessibility(&unit), params), unit.speed);
+		EXPECT_EQ(snapshot.reachableHexes(unit), expected) << "Wrong reachability of " << stack->nodeName();
+	}
+
+	EXPECT_FALSE(snapshot.reachableHexes(unitOf(snapshot, pikeman))[gate]);
+	EXPECT_TRUE(snapshot.reachableHexes(unitOf(snapshot, swordsman))[gate]);
+	EXPECT_TRUE(snapshot.reachableHexes(unitOf(snapshot, swordsman))[BattleHex(7, 5)]);
+}
+
+TEST_F(BattleStateSnapshotTest, damageMatchesBattleEstimate)
+{
+	const CStack * pikeman = addStack(PIKEMAN, 10, BattleSide::ATTACKER, BattleHex(5, 5));
+	const CStack * archer = addStack(ARCHER, 8, BattleSide::ATTACKER, BattleHex(1, 3));
+	const CStack * swordsman = addStack(SWORDSMAN, 5, BattleSide::DEFENDER, BattleHex(6, 5));
+	const CStack * griffin = addStack(GRIFFIN, 4, BattleSide::DEFENDER, BattleHex(8, 3));
+
+	BattleStateSnapshot snapshot(&battle);
+	auto & rand = CRandomGenerator::getDefault();
+	auto average = [](std::pair<ui32, ui32> range)
+	{
+		return (range.first + range.second) / 2.0;
+	};
+
+	//melee
+	EXPECT_NEAR(snapshot.estimateDamage(unitOf(snapshot, pikeman), unitOf(snapshot, swordsman), false),
+		average(battle.battleEstimateDamage(rand, pikeman, swordsman)), 1.0);
+	EXPECT_NEAR(snapshot.estimateDamage(unitOf(snapshot, swordsman), unitOf(snapshot, pikeman), false),
+		average(battle.battleEstimateDamage(rand, swordsman, pikeman)), 1.0);
+
+	//shooting from distance without penalty
+	ASSERT_TRUE(battle.battleCanShoot(archer, griffin->position));
+	EXPECT_NEAR(snapshot.estimateDamage(unitOf(snapshot, archer), unitOf(snapshot, griffin), true),
+		average(battle.battleEstimateDamage(rand, archer, griffin)), 1.0);
+}
+
+TEST_F(BattleStateSnapshotTest, greedyTurnAttacksReachableEnemy)
+{
+	const CStack * pikeman = addStack(PIKEMAN, 10, BattleSide::ATTACKER, BattleHex(4, 5));
+	const CStack * archer = addStack(ARCHER, 8, BattleSide::ATTACKER, BattleHex(1, 3));
+	const CStack * swordsman = addStack(SWORDSMAN, 5, BattleSide::DEFENDER, BattleHex(8, 5));
+
+	BattleStateSnapshot snapshot(&battle);
+	const si64 pikemanHealth = unitOf(snapshot, pikeman).totalHealth();
+	const si64 archerHealth = unitOf(snapshot, archer).totalHealth();
+	snapshot.playGreedyTurn(BattleSide::DEFENDER);
+
+	//only pikemen are in reach of swordsmen
+	const auto & attacker = unitOf(snapshot, swordsman);
+	EXPECT_TRUE(snapshot.isMeleeAttackPossible(attacker, unitOf(snapshot, pikeman), attacker.position));
+	EXPECT_LT(unitOf(snapshot, pikeman).totalHealth(), pikemanHealth);
+	EXPECT_EQ(unitOf(snapshot, archer).totalHealth(), archerHealth);
+}